@@ -12,6 +12,25 @@
  */
 kernel_t* kernel;
 
+/**
+ * The CPU-Thread and whether it has been
+ * requested to halt, which is read and
+ * written holding the mutex.
+ */
+static pthread_t cpu_id;
+static pthread_mutex_t cpu_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int cpu_halted = 0;
+
+/* Internal CPU Function Prototype */
+
+/**
+ * It exits the CPU-Thread if it has been
+ * requested to halt. It is only called
+ * between system calls, such that none of
+ * them is left halfway.
+ */
+static void cpu_checkpoint();
+
 /* CPU Function Definition */
 
 /**
@@ -21,7 +40,6 @@ kernel_t* kernel;
  * execution along the simulation.
  */
 void cpu_init() {
-    pthread_t cpu_id;
     pthread_attr_t cpu_attr;
 
     pthread_attr_init(&cpu_attr);
@@ -30,6 +48,20 @@ void cpu_init() {
     pthread_create(&cpu_id, NULL, (void*)cpu, NULL);
 }
 
+/**
+ * It halts the CPU-Thread and waits for
+ * it to exit, such that no system call
+ * runs afterwards (e.g., while the file
+ * system is reported and unmounted).
+ */
+void cpu_halt() {
+    pthread_mutex_lock(&cpu_mutex);
+    cpu_halted = 1;
+    pthread_mutex_unlock(&cpu_mutex);
+
+    pthread_join(cpu_id, NULL);
+}
+
 /**
  * It represents the function that
  * is going to simulate the CPU work
@@ -48,6 +80,14 @@ _Noreturn void cpu() {
 
     int no_process = 0;
     while (1) {
+        cpu_checkpoint();
+
+        /* It unblocks the processes whose disk operations have completed */
+        volume_reap(&kernel->volume);
+
+        /* It commits the metadata transaction that has stayed open too long */
+        sysCall(FS_JOURNAL_COMMIT, NULL);
+
         /* It checks if there is no scheduled proc */
         if (!kernel->scheduler.scheduled_proc) {
             if (!no_process) {
@@ -64,6 +104,9 @@ _Noreturn void cpu() {
         else {
             no_process = 0;
             do {
+                cpu_checkpoint();
+                volume_reap(&kernel->volume);
+
                 clock_gettime(CLOCK_REALTIME, &end);
                 const int elapsed = (end.tv_sec - start.tv_sec) * ONE_SECOND_NS
                                     + (end.tv_nsec - start.tv_nsec);
@@ -75,26 +118,22 @@ _Noreturn void cpu() {
                      * virtual memory address */
                     const int pc
                         = FETCH_INSTR_ADDR(kernel->scheduler.scheduled_proc);
-                    const int page_number = PAGE_NUMBER(pc);
-                    const int page_offset = PAGE_OFFSET(pc);
+                    instr_t instr;
 
-                    /* Fetch the instruction from the page stored in the memory
-                     */
+                    /* Fetch the instruction from the page stored in the memory.
+                     * The time spent servicing a page fault is charged to the
+                     * process */
                     segment_t* seg = segment_find(
                         &kernel->seg_table,
                         kernel->scheduler.scheduled_proc->seg_id);
-                    page_t* page = &seg->page_table[page_number];
-                    instr_t instr = page->code[page_offset];
-
-                    /* It set the used bit if it is not set */
-                    if (!page->used)
-                        page->used = 1;
+                    kernel->scheduler.scheduled_proc->remaining
+                        -= memory_fetch(&kernel->seg_table, seg, pc, &instr);
 
                     process_log(kernel->scheduler.scheduled_proc->name,
                                 kernel->scheduler.scheduled_proc->remaining,
                                 pc,
                                 seg->id,
-                                kernel->scheduler.scheduled_proc->o_files->size);
+                                kernel->scheduler.scheduled_proc->o_files.size);
                     sem_post(&log_mutex);
                     sem_post(&refresh_sem);
 
@@ -113,8 +152,14 @@ _Noreturn void cpu() {
             /* The process has finished its execution, then it must be
              * terminated */
             if (kernel->scheduler.scheduled_proc->pc
-                >= kernel->scheduler.scheduled_proc->code_len)
-                sysCall(PROCESS_FINISH, kernel->scheduler.scheduled_proc);
+                >= kernel->scheduler.scheduled_proc->code_len) {
+                /* It waits for the asynchronous reads not awaited by the
+                 * process, such that it is finished once they complete */
+                if (kernel->scheduler.scheduled_proc->aio_pending > 0)
+                    sysCall(DISK_AWAIT_REQUEST, NULL);
+                else
+                    sysCall(PROCESS_FINISH, kernel->scheduler.scheduled_proc);
+            }
             else
                 /* Interrupt the current process to schedule another one, since
                  * the latter */
@@ -123,3 +168,20 @@ _Noreturn void cpu() {
         }
     }
 }
+
+/* Internal CPU Function Definition */
+
+/**
+ * It exits the CPU-Thread if it has been
+ * requested to halt. It is only called
+ * between system calls, such that none of
+ * them is left halfway.
+ */
+static void cpu_checkpoint() {
+    pthread_mutex_lock(&cpu_mutex);
+    const int halted = cpu_halted;
+    pthread_mutex_unlock(&cpu_mutex);
+
+    if (halted)
+        pthread_exit(NULL);
+}
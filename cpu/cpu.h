@@ -16,6 +16,14 @@
  */
 void cpu_init();
 
+/**
+ * It halts the CPU-Thread and waits for
+ * it to exit, such that no system call
+ * runs afterwards (e.g., while the file
+ * system is reported and unmounted).
+ */
+void cpu_halt();
+
 /**
  * It represents the function that
  * is going to simulate the CPU work
@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "buffer.h"
+
+/**
+ * It represents a pending sync request, that
+ * completes once no buffer written up to its
+ * write sequence is dirty anymore.
+ */
+typedef struct BufferSync {
+    void* waiter;
+    long seq;
+} buffer_sync_t;
+
+/* Buffer Cache Internal Function Definitions */
+
+/**
+ * It returns the current time in milliseconds.
+ */
+static long now_ms() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
+
+/**
+ * It returns the hash bucket of the specified block.
+ */
+static buffer_t** buffer_bucket(const buffer_cache_t* cache, int block) {
+    return &cache->hash[((unsigned int) block * 2654435761u) & (cache->hash_size - 1)];
+}
+
+/**
+ * It returns the buffer storing the specified
+ * block or NULL if the block is not cached. It is
+ * supposed that the buffer cache mutex is held.
+ */
+static buffer_t* buffer_find(const buffer_cache_t* cache, int block) {
+    buffer_t* buf;
+
+    for (buf = *buffer_bucket(cache, block); buf != NULL; buf = buf->hash_next)
+        if (buf->block == block)
+            return buf;
+
+    return NULL;
+}
+
+/**
+ * It unlinks the buffer from the LRU list. It is
+ * supposed that the buffer cache mutex is held.
+ */
+static void lru_unlink(buffer_cache_t* cache, buffer_t* buf) {
+    if (buf->prev)
+        buf->prev->next = buf->next;
+    else cache->lru_head = buf->next;
+
+    if (buf->next)
+        buf->next->prev = buf->prev;
+    else cache->lru_tail = buf->prev;
+}
+
+/**
+ * It puts the buffer as the most recently used one. It
+ * is supposed that the buffer cache mutex is held.
+ */
+static void lru_push(buffer_cache_t* cache, buffer_t* buf) {
+    buf->prev = NULL;
+    buf->next = cache->lru_head;
+
+    if (cache->lru_head)
+        cache->lru_head->prev = buf;
+    else cache->lru_tail = buf;
+    cache->lru_head = buf;
+}
+
+/**
+ * It removes the buffer from its hash bucket. It is
+ * supposed that the buffer cache mutex is held.
+ */
+static void hash_remove(buffer_cache_t* cache, buffer_t* buf) {
+    buffer_t** link = buffer_bucket(cache, buf->block);
+
+    while (*link != buf)
+        link = &(*link)->hash_next;
+    *link = buf->hash_next;
+}
+
+/**
+ * It returns a buffer to store the specified block,
+ * either a free one or the least recently used clean
+ * one. If every buffer is dirty, then NULL is returned.
+ * It is supposed that the buffer cache mutex is held.
+ */
+static buffer_t* buffer_alloc(buffer_cache_t* cache, int block) {
+    buffer_t* buf;
+
+    if (cache->size < cache->capacity)
+        buf = &cache->buffers[cache->size++];
+    else {
+        /* The dirty buffers cannot be evicted until written back */
+        for (buf = cache->lru_tail; buf != NULL && buf->dirty; buf = buf->prev);
+
+        if (!buf)
+            return NULL;
+
+        lru_unlink(cache, buf);
+        hash_remove(cache, buf);
+        cache->evict_count++;
+
+        /* It checks if the block has been read ahead for nothing */
+        if (buf->ahead)
+            cache->ahead_wasted++;
+    }
+
+    buf->block = block;
+    buf->dirty = 0;
+    buf->flushing = 0;
+    buf->ahead = 0;
+    buf->hash_next = *buffer_bucket(cache, block);
+    *buffer_bucket(cache, block) = buf;
+    lru_push(cache, buf);
+
+    return buf;
+}
+
+/**
+ * It returns 1 if some buffer written up to the specified
+ * write sequence is still dirty. Otherwise, 0 is returned.
+ * It is supposed that the buffer cache mutex is held.
+ */
+static int buffer_dirty_since(const buffer_cache_t* cache, long seq) {
+    register int i;
+
+    for (i = 0; i < cache->size; i++)
+        if (cache->buffers[i].dirty && cache->buffers[i].dirty_seq <= seq)
+            return 1;
+
+    return 0;
+}
+
+/* Buffer Cache Function Definitions */
+
+/**
+ * It initializes the buffer cache.
+ *
+ * @param cache the buffer cache
+ * @param capacity the maximum amount of blocks
+ */
+void buffer_cache_init(buffer_cache_t* cache, int capacity) {
+    cache->hash_size = 1;
+    while (cache->hash_size < capacity << 1)
+        cache->hash_size <<= 1;
+
+    cache->buffers = (buffer_t *)malloc(sizeof(buffer_t) * capacity);
+    cache->hash = (buffer_t **)calloc(cache->hash_size, sizeof(buffer_t *));
+
+    /* It checks if the buffers could not be allocated */
+    if (!cache->buffers || !cache->hash) {
+        printf("Not enough memory to allocate the buffer cache.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    cache->capacity = capacity;
+    cache->size = 0;
+    cache->lru_head = NULL;
+    cache->lru_tail = NULL;
+    pthread_mutex_init(&cache->mutex, NULL);
+    pthread_cond_init(&cache->flush, NULL);
+
+    cache->write_back = BUFFER_WRITE_BACK;
+    cache->dirty_count = 0;
+    cache->write_seq = 0;
+    cache->force_flush = 0;
+    cache->sync_waiters = list_init();
+
+    cache->hit_count = 0;
+    cache->miss_count = 0;
+    cache->evict_count = 0;
+    cache->absorbed_count = 0;
+    cache->direct_count = 0;
+    cache->writeback_count = 0;
+    cache->sync_count = 0;
+    cache->ahead_count = 0;
+    cache->ahead_hits = 0;
+    cache->ahead_wasted = 0;
+}
+
+/**
+ * It looks the specified block up for a read. If the
+ * block is cached, then it becomes the most recently
+ * used one.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ *
+ * @return 1 if the block is cached; otherwise,
+ *         0 is returned.
+ */
+int buffer_cache_read(buffer_cache_t* cache, int block) {
+    buffer_t* buf;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    if ((buf = buffer_find(cache, block))) {
+        lru_unlink(cache, buf);
+        lru_push(cache, buf);
+        cache->hit_count++;
+
+        /* It checks if the read has been anticipated */
+        if (buf->ahead) {
+            buf->ahead = 0;
+            cache->ahead_hits++;
+        }
+    } else cache->miss_count++;
+
+    pthread_mutex_unlock(&cache->mutex);
+    return buf != NULL;
+}
+
+/**
+ * It stores the specified block after it has been
+ * transferred from/to the disk, evicting the least
+ * recently used block if the cache is full.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ * @param ahead if it is 1, then the block has been
+ *              read ahead (speculatively)
+ */
+void buffer_cache_fill(buffer_cache_t* cache, int block, int ahead) {
+    buffer_t* buf;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    /* It checks if the block is already cached */
+    if ((buf = buffer_find(cache, block))) {
+        lru_unlink(cache, buf);
+        lru_push(cache, buf);
+    } else if ((buf = buffer_alloc(cache, block)))
+        buf->ahead = ahead;
+
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * It returns 1 if the specified block must be read
+ * ahead, that is, if it is not cached. Otherwise, 0
+ * is returned.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ */
+int buffer_cache_read_ahead(buffer_cache_t* cache, int block) {
+    int must_read;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    if ((must_read = buffer_find(cache, block) == NULL))
+        cache->ahead_count++;
+
+    pthread_mutex_unlock(&cache->mutex);
+    return must_read;
+}
+
+/**
+ * It writes the specified block into a dirty
+ * buffer, such that it is written back later.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ *
+ * @return 1 if the write has been absorbed by the
+ *         cache; otherwise, if the write back is
+ *         disabled or every buffer is dirty, then
+ *         0 is returned and the block must be
+ *         written to the disk.
+ */
+int buffer_cache_write(buffer_cache_t* cache, int block) {
+    buffer_t* buf;
+
+    if (!cache->write_back)
+        return 0;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    if ((buf = buffer_find(cache, block))) {
+        lru_unlink(cache, buf);
+        lru_push(cache, buf);
+    } else if (!(buf = buffer_alloc(cache, block))) {
+        /* Every buffer is dirty, hence the flusher is woken up */
+        cache->direct_count++;
+        pthread_cond_signal(&cache->flush);
+        pthread_mutex_unlock(&cache->mutex);
+        return 0;
+    }
+
+    if (!buf->dirty) {
+        buf->dirty = 1;
+        buf->dirtied_ms = now_ms();
+        cache->dirty_count++;
+    }
+    buf->dirty_seq = ++cache->write_seq;
+    cache->absorbed_count++;
+
+    /* It checks if there are too many dirty buffers */
+    if (cache->dirty_count > cache->capacity * BUFFER_DIRTY_RATIO)
+        pthread_cond_signal(&cache->flush);
+
+    pthread_mutex_unlock(&cache->mutex);
+    return 1;
+}
+
+/**
+ * It waits until some dirty buffers must be flushed,
+ * either because they are too old, there are too many
+ * of them or a sync has been requested.
+ *
+ * @param cache the buffer cache
+ * @param blocks an array (of capacity size) to
+ *               receive the blocks to be flushed
+ *
+ * @return the amount of blocks to be flushed
+ */
+int buffer_cache_flush_wait(buffer_cache_t* cache, int* blocks) {
+    struct timespec deadline;
+    int count = 0;
+    register int i;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    while (1) {
+        const long now = now_ms();
+        const int flush_all = cache->force_flush
+                              || cache->dirty_count > cache->capacity * BUFFER_DIRTY_RATIO;
+
+        /* It picks the dirty buffers whose write-back has not */
+        /* been issued yet, either all or only the old ones */
+        for (i = 0; i < cache->size; i++) {
+            buffer_t* buf = &cache->buffers[i];
+
+            if (buf->dirty && !buf->flushing
+                && (flush_all || now - buf->dirtied_ms >= BUFFER_DIRTY_AGE_MS)) {
+                buf->flushing = 1;
+                buf->flush_seq = buf->dirty_seq;
+                blocks[count++] = buf->block;
+            }
+        }
+        cache->force_flush = 0;
+
+        if (count > 0)
+            break;
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += BUFFER_FLUSH_INTERVAL_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&cache->flush, &cache->mutex, &deadline);
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+    return count;
+}
+
+/**
+ * It marks the specified block as clean after its
+ * write-back has been done. If the block has been
+ * written meanwhile, then it is kept dirty.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ */
+void buffer_cache_clean(buffer_cache_t* cache, int block) {
+    buffer_t* buf;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    if ((buf = buffer_find(cache, block)) && buf->flushing) {
+        buf->flushing = 0;
+        cache->writeback_count++;
+
+        if (buf->dirty_seq == buf->flush_seq) {
+            buf->dirty = 0;
+            cache->dirty_count--;
+        }
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * It requests every write made so far to be flushed.
+ * The waiter is returned by buffer_cache_sync_done
+ * when that happens.
+ *
+ * @param cache the buffer cache
+ * @param waiter the waiter
+ *
+ * @return 1 if the waiter must wait; otherwise, if
+ *         there is no dirty buffer, 0 is returned.
+ */
+int buffer_cache_sync(buffer_cache_t* cache, void* waiter) {
+    buffer_sync_t* sync;
+
+    pthread_mutex_lock(&cache->mutex);
+    cache->sync_count++;
+
+    /* It checks if every write is already durable */
+    if (cache->dirty_count == 0) {
+        pthread_mutex_unlock(&cache->mutex);
+        return 0;
+    }
+
+    sync = (buffer_sync_t *)malloc(sizeof(buffer_sync_t));
+
+    /* It checks if the sync request could not be allocated */
+    if (!sync) {
+        printf("Not enough memory to allocate a sync request.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sync->waiter = waiter;
+    sync->seq = cache->write_seq;
+    list_add(cache->sync_waiters, sync);
+
+    /* It wakes the flusher up to write every dirty buffer */
+    cache->force_flush = 1;
+    pthread_cond_signal(&cache->flush);
+
+    pthread_mutex_unlock(&cache->mutex);
+    return 1;
+}
+
+/**
+ * It returns a waiter whose sync request has
+ * completed or NULL if there is none.
+ *
+ * @param cache the buffer cache
+ */
+void* buffer_cache_sync_done(buffer_cache_t* cache) {
+    list_node_t* sync_node;
+    void* waiter = NULL;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    for (sync_node = cache->sync_waiters->head; sync_node != NULL; sync_node = sync_node->next) {
+        buffer_sync_t* sync = (buffer_sync_t *)sync_node->content;
+
+        if (!buffer_dirty_since(cache, sync->seq)) {
+            waiter = sync->waiter;
+
+            list_remove_node(cache->sync_waiters, sync_node);
+            list_node_free(sync_node);
+            free(sync);
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+    return waiter;
+}
+
+/**
+ * It returns the amount of dirty buffers
+ * in the buffer cache.
+ *
+ * @param cache the buffer cache
+ */
+int buffer_cache_dirty(buffer_cache_t* cache) {
+    int dirty;
+
+    pthread_mutex_lock(&cache->mutex);
+    dirty = cache->dirty_count;
+    pthread_mutex_unlock(&cache->mutex);
+
+    return dirty;
+}
+
+/**
+ * It returns the ratio of the reads that
+ * have been served from the buffer cache.
+ *
+ * @param cache the buffer cache
+ */
+double buffer_cache_hit_ratio(buffer_cache_t* cache) {
+    double ratio;
+
+    pthread_mutex_lock(&cache->mutex);
+    ratio = cache->hit_count + cache->miss_count > 0
+            ? (double) cache->hit_count / (cache->hit_count + cache->miss_count) : 0.0;
+    pthread_mutex_unlock(&cache->mutex);
+
+    return ratio;
+}
+
+/**
+ * It prints the buffer cache statistics.
+ *
+ * @param cache the buffer cache
+ * @param fp the file to be printed to
+ */
+void buffer_cache_report(buffer_cache_t* cache, FILE* fp) {
+    const double hit_ratio = buffer_cache_hit_ratio(cache);
+
+    pthread_mutex_lock(&cache->mutex);
+
+    fprintf(fp, "Buffer cache: %ld read hits, %ld read misses (hit ratio %.1lf%%), %ld evictions\n",
+            cache->hit_count, cache->miss_count, hit_ratio * 100.0, cache->evict_count);
+    fprintf(fp, "Write-back %s: %ld writes absorbed, %ld written directly, %ld written back, "
+                "%d dirty, %ld syncs\n", cache->write_back ? "on" : "off",
+            cache->absorbed_count, cache->direct_count, cache->writeback_count,
+            cache->dirty_count, cache->sync_count);
+    fprintf(fp, "Read-ahead: %ld issued, %ld hits, %ld wasted, accuracy %.1lf%%\n",
+            cache->ahead_count, cache->ahead_hits, cache->ahead_wasted,
+            cache->ahead_count > 0 ? 100.0 * cache->ahead_hits / cache->ahead_count : 0.0);
+
+    pthread_mutex_unlock(&cache->mutex);
+}
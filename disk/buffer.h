@@ -0,0 +1,328 @@
+#ifndef OS_PROJECT_BUFFER_H
+#define OS_PROJECT_BUFFER_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "../tools/list.h"
+
+/**
+ * It represents the default amount of
+ * blocks the buffer cache may hold.
+ */
+#define BUFFER_CACHE_CAPACITY (64)
+
+/**
+ * It represents the amount of time (u.t.)
+ * charged to a process whose read has been
+ * served from the buffer cache.
+ */
+#define BUFFER_CACHE_HIT_TIME (50)
+
+/**
+ * If it is set, then the writes land in dirty
+ * buffers that are written back by the flusher
+ * thread. Otherwise, the writes go straight to
+ * the disk.
+ */
+#define BUFFER_WRITE_BACK (0)
+
+/**
+ * It represents the ratio of dirty buffers
+ * above which every dirty buffer is flushed.
+ */
+#define BUFFER_DIRTY_RATIO (0.5)
+
+/**
+ * It represents the time (ms) a buffer may
+ * stay dirty before it is flushed and the
+ * time (ms) between the flusher wake ups.
+ */
+#define BUFFER_DIRTY_AGE_MS (3000)
+#define BUFFER_FLUSH_INTERVAL_MS (500)
+
+/**
+ * It represents the maximum amount of tracks
+ * read ahead of a process reading sequentially.
+ */
+#define BUFFER_READ_AHEAD_MAX (8)
+
+/**
+ * It represents a disk block
+ * held by the buffer cache.
+ */
+typedef struct Buffer {
+    /**
+     * It holds the disk block
+     * stored in this buffer.
+     */
+    int block;
+
+    /**
+     * It points to the previous (more recently
+     * used) and to the next (less recently used)
+     * buffers in the LRU list.
+     */
+    struct Buffer* prev;
+    struct Buffer* next;
+
+    /**
+     * It points to the next buffer
+     * in the same hash bucket.
+     */
+    struct Buffer* hash_next;
+
+    /**
+     * It is set when the buffer holds data
+     * that has not been written to the disk
+     * yet, and when its write-back has been
+     * issued, respectively.
+     */
+    int dirty;
+    int flushing;
+
+    /**
+     * It holds the write sequence of the last
+     * write to this buffer and of the write
+     * being flushed, such that a write made
+     * while flushing keeps the buffer dirty.
+     */
+    long dirty_seq;
+    long flush_seq;
+
+    /**
+     * It holds the time (ms) in which
+     * the buffer has become dirty.
+     */
+    long dirtied_ms;
+
+    /**
+     * It is set when the block has been read
+     * ahead and it has not been read since.
+     */
+    int ahead;
+} buffer_t;
+
+typedef struct BufferCache {
+    /**
+     * It holds the buffers, the maximum
+     * amount of them and the amount of
+     * them in use.
+     */
+    buffer_t* buffers;
+    int capacity;
+    int size;
+
+    /**
+     * It holds the hash table mapping a
+     * disk block to its buffer and the
+     * amount of buckets (a power of two).
+     */
+    buffer_t** hash;
+    int hash_size;
+
+    /**
+     * It points to the most recently and
+     * to the least recently used buffers.
+     */
+    buffer_t* lru_head;
+    buffer_t* lru_tail;
+
+    /**
+     * It ensures mutual exclusion when
+     * handling the buffer cache, and it
+     * wakes the flusher thread up.
+     */
+    pthread_mutex_t mutex;
+    pthread_cond_t flush;
+
+    /**
+     * It is set if the writes are
+     * written back (see BUFFER_WRITE_BACK).
+     */
+    int write_back;
+
+    /**
+     * It holds the amount of dirty buffers
+     * and the sequence of the last write.
+     */
+    int dirty_count;
+    long write_seq;
+
+    /**
+     * It is set when every dirty buffer
+     * must be flushed right away.
+     */
+    int force_flush;
+
+    /**
+     * It holds the waiters of the sync
+     * requests that have not completed.
+     */
+    list_t* sync_waiters;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of reads served
+     * from the cache, the amount of reads
+     * that went to the disk and the amount
+     * of evicted buffers.
+     */
+    long hit_count;
+    long miss_count;
+    long evict_count;
+
+    /**
+     * It holds the amount of writes absorbed
+     * by dirty buffers, the amount of writes
+     * that went straight to the disk since no
+     * buffer was available, the amount of
+     * written back buffers and the amount of
+     * sync requests.
+     */
+    long absorbed_count;
+    long direct_count;
+    long writeback_count;
+    long sync_count;
+
+    /**
+     * It holds the amount of issued read-aheads,
+     * the amount of read-ahead blocks that have
+     * been read afterwards and the amount of
+     * them evicted without being read.
+     */
+    long ahead_count;
+    long ahead_hits;
+    long ahead_wasted;
+} buffer_cache_t;
+
+/* Buffer Cache Function Prototypes */
+
+/**
+ * It initializes the buffer cache.
+ *
+ * @param cache the buffer cache
+ * @param capacity the maximum amount of blocks
+ */
+void buffer_cache_init(buffer_cache_t* cache, int capacity);
+
+/**
+ * It looks the specified block up for a read. If the
+ * block is cached, then it becomes the most recently
+ * used one.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ *
+ * @return 1 if the block is cached; otherwise,
+ *         0 is returned.
+ */
+int buffer_cache_read(buffer_cache_t* cache, int block);
+
+/**
+ * It stores the specified block after it has been
+ * transferred from/to the disk, evicting the least
+ * recently used block if the cache is full.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ * @param ahead if it is 1, then the block has been
+ *              read ahead (speculatively)
+ */
+void buffer_cache_fill(buffer_cache_t* cache, int block, int ahead);
+
+/**
+ * It returns 1 if the specified block must be read
+ * ahead, that is, if it is not cached. Otherwise, 0
+ * is returned.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ */
+int buffer_cache_read_ahead(buffer_cache_t* cache, int block);
+
+/**
+ * It writes the specified block into a dirty
+ * buffer, such that it is written back later.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ *
+ * @return 1 if the write has been absorbed by the
+ *         cache; otherwise, if the write back is
+ *         disabled or every buffer is dirty, then
+ *         0 is returned and the block must be
+ *         written to the disk.
+ */
+int buffer_cache_write(buffer_cache_t* cache, int block);
+
+/**
+ * It waits until some dirty buffers must be flushed,
+ * either because they are too old, there are too many
+ * of them or a sync has been requested.
+ *
+ * @param cache the buffer cache
+ * @param blocks an array (of capacity size) to
+ *               receive the blocks to be flushed
+ *
+ * @return the amount of blocks to be flushed
+ */
+int buffer_cache_flush_wait(buffer_cache_t* cache, int* blocks);
+
+/**
+ * It marks the specified block as clean after its
+ * write-back has been done. If the block has been
+ * written meanwhile, then it is kept dirty.
+ *
+ * @param cache the buffer cache
+ * @param block the disk block
+ */
+void buffer_cache_clean(buffer_cache_t* cache, int block);
+
+/**
+ * It requests every write made so far to be flushed.
+ * The waiter is returned by buffer_cache_sync_done
+ * when that happens.
+ *
+ * @param cache the buffer cache
+ * @param waiter the waiter
+ *
+ * @return 1 if the waiter must wait; otherwise, if
+ *         there is no dirty buffer, 0 is returned.
+ */
+int buffer_cache_sync(buffer_cache_t* cache, void* waiter);
+
+/**
+ * It returns a waiter whose sync request has
+ * completed or NULL if there is none.
+ *
+ * @param cache the buffer cache
+ */
+void* buffer_cache_sync_done(buffer_cache_t* cache);
+
+/**
+ * It returns the amount of dirty buffers
+ * in the buffer cache.
+ *
+ * @param cache the buffer cache
+ */
+int buffer_cache_dirty(buffer_cache_t* cache);
+
+/**
+ * It returns the ratio of the reads that
+ * have been served from the buffer cache.
+ *
+ * @param cache the buffer cache
+ */
+double buffer_cache_hit_ratio(buffer_cache_t* cache);
+
+/**
+ * It prints the buffer cache statistics.
+ *
+ * @param cache the buffer cache
+ * @param fp the file to be printed to
+ */
+void buffer_cache_report(buffer_cache_t* cache, FILE* fp);
+
+#endif // OS_PROJECT_BUFFER_H
@@ -1,8 +1,15 @@
 #include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
 #include "disk.h"
+#include "disk_policy.h"
+#include "disk_timing.h"
+#include "volume.h"
+#include "../tools/math.h"
+#include "../tools/slab.h"
 
 #ifndef OS_SCHED_KERNEL
 #define OS_SCHED_KERNEL
@@ -10,8 +17,21 @@
 #include "../terminal/terminal.h"
 #endif // OS_SCHED_KERNEL
 
+/**
+ * It expands to the amount of served requests and
+ * their mean latency (u.t.) for the specified class.
+ */
+#define DISK_IOCLASS_STATS(ds, ioclass) (ds)->class_requests[ioclass], \
+    (ds)->class_requests[ioclass] > 0 ? (double) (ds)->class_latency[ioclass] / (ds)->class_requests[ioclass] : 0.0
+
 #define MILLISECONDS_100 (50000000L)
 
+/**
+ * The slab cache from which the
+ * disk requests are allocated.
+ */
+static slab_cache_t disk_request_cache = SLAB_CACHE_INITIALIZER("disk_request", disk_request_t);
+
 /* Internal Disk Function Prototypes */
 
 /**
@@ -19,27 +39,104 @@
  * those pending requests that are over the
  * specified track.
  *
+ * @param disk_scheduler the disk scheduler
  * @param track the specified track
  */
-static void rw_disk_op_resolve(int track);
+static void rw_disk_op_resolve(disk_scheduler_t* disk_scheduler, int track);
+
+/**
+ * It moves the disk arm straight to the next track
+ * chosen by the disk scheduling policy. Further, if
+ * there is no pending request at all, the arm stays
+ * on the current track.
+ *
+ * @param disk_scheduler the disk scheduler
+ *
+ * @return 1 if the arm has moved to an adjacent
+ *         track, which is served in the same sweep
+ *         segment; otherwise, 0 is returned.
+ */
+static int disk_arm_move(disk_scheduler_t* disk_scheduler);
+
+/**
+ * It returns the next track chosen by the disk
+ * scheduling policy among the tracks pending in the
+ * highest I/O class having pending requests, unless
+ * a lower class has waited longer than its bound,
+ * which is served instead. If there is no pending
+ * request, then -1 is returned. It is supposed that
+ * the disk scheduler mutex is held.
+ *
+ * @param disk_scheduler the disk scheduler
+ */
+static int disk_ioclass_next_track(disk_scheduler_t* disk_scheduler);
+
+/**
+ * It represents the function that is going to
+ * write the dirty buffers of the buffer cache
+ * back to the disk.
+ */
+_Noreturn static void disk_flusher();
+
+/**
+ * It compares two blocks by their track.
+ */
+static int block_cmp(const void* b1, const void* b2);
+
+/**
+ * It records the disk request in the disk trace.
+ * If the trace has reached DISK_TRACE_LIMIT, then
+ * the request is only counted. It is supposed that
+ * the disk scheduler mutex is held.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param disk_req the disk request
+ */
+static void disk_trace_add(disk_scheduler_t* disk_scheduler, const disk_request_t* disk_req);
+
+/**
+ * It queues the submitted request into its track
+ * pending requests, merging it into a pending
+ * operation if possible. It is supposed that the
+ * disk scheduler mutex is held.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param sqe the submitted request
+ */
+static void disk_enqueue(disk_scheduler_t* disk_scheduler, const disk_sqe_t* sqe);
+
+/**
+ * It takes the requests submitted by every producer
+ * and it queues them into the disk scheduler.
+ *
+ * @param disk_scheduler the disk scheduler
+ */
+static void disk_drain(disk_scheduler_t* disk_scheduler);
 
 /* Disk Function Prototypes */
 
 /**
- * It creates the DiskScheduler-Thread that
- * is going to run the Hard DiskScheduler function
- * that is going to simulate the hard
- * disk work along the operating system
- * simulation.
+ * It creates a DiskScheduler-Thread for each
+ * disk of the volume that is going to run the
+ * Hard DiskScheduler function that is going to
+ * simulate the hard disk work along the operating
+ * system simulation. If the volume is backed by
+ * the flash device, then a single thread runs it.
  */
 void disk_init() {
     pthread_t disk_id;
+    pthread_t flusher_id;
     pthread_attr_t disk_attr;
+    register int i;
 
     pthread_attr_init(&disk_attr);
     pthread_attr_setscope(&disk_attr, PTHREAD_SCOPE_SYSTEM);
 
-    pthread_create(&disk_id, NULL, (void*)disk, NULL);
+    if (kernel->volume.backend == VOLUME_SSD)
+        pthread_create(&disk_id, NULL, (void*)ssd_run, &kernel->volume.ssd);
+    else for (i = 0; i < kernel->volume.disk_count; i++)
+        pthread_create(&disk_id, NULL, (void*)disk, &kernel->volume.disks[i]);
+    pthread_create(&flusher_id, NULL, (void*)disk_flusher, NULL);
 }
 
 /**
@@ -48,13 +145,20 @@ void disk_init() {
  * disk work by moving its arm
  * over the disk surface making
  * reading and writing.
+ *
+ * @param disk_scheduler the scheduler of
+ *                       the simulated disk
  */
-_Noreturn void disk() {
+_Noreturn void disk(disk_scheduler_t* disk_scheduler) {
     struct timespec start;
     struct timespec end;
 
     clock_gettime(CLOCK_REALTIME, &start);
     while (1) {
+        /* The submitted requests are queued as soon as they are seen, */
+        /* such that they are estimated against the current arm */
+        disk_drain(disk_scheduler);
+
         clock_gettime(CLOCK_REALTIME, &end);
         const int elapsed = (end.tv_sec - start.tv_sec) * 1000000000L
                             + (end.tv_nsec - start.tv_nsec);
@@ -63,28 +167,26 @@ _Noreturn void disk() {
             start = end;
 
             /* It resolves the disk read/write operations for the current track */
-            rw_disk_op_resolve(kernel->disk_scheduler.curr_track);
-
-            if (kernel->disk_scheduler.forward_dir) {
-                if (kernel->disk_scheduler.curr_track == DISK_TRACK_LIMIT)
-                    kernel->disk_scheduler.forward_dir = 0;
-                else
-                    kernel->disk_scheduler.curr_track++;
-            } else {
-                if (kernel->disk_scheduler.curr_track == 0)
-                    kernel->disk_scheduler.forward_dir = 1;
-                else
-                    kernel->disk_scheduler.curr_track--;
-            }
+            /* and for the adjacent tracks the scheduling policy chooses next */
+            /* in the same sweep, skipping those without pending requests */
+            do
+                rw_disk_op_resolve(disk_scheduler, disk_scheduler->curr_track);
+            while (disk_arm_move(disk_scheduler));
 
-            /* It updates some miscellaneous information */
-            kernel->disk_scheduler.angular_v = (int) (DISk_BASE_ANGULAR_V + 100 * sin(kernel->disk_scheduler.curr_track));
+            /* The completions of the whole tick are published at once */
+            disk_complete_publish(&disk_scheduler->rings);
 
-            /* It updates the disk forward direction log */
-            disk_general_log->forward_dir = kernel->disk_scheduler.forward_dir;
-            disk_general_log->curr_track = kernel->disk_scheduler.curr_track;
-            disk_general_log->angular_v = kernel->disk_scheduler.angular_v;
-            disk_general_log->pending_requests_size = kernel->disk_scheduler.pending_requests->size;
+            /* It updates some miscellaneous information */
+            disk_scheduler->angular_v = (int) (DISk_BASE_ANGULAR_V + 100 * sin(disk_scheduler->curr_track));
+
+            /* It updates the disk forward direction log, that */
+            /* shows the first disk arm and the whole volume load */
+            if (disk_scheduler->id == 0) {
+                disk_general_log->forward_dir = disk_scheduler->forward_dir;
+                disk_general_log->curr_track = disk_scheduler->curr_track;
+                disk_general_log->angular_v = disk_scheduler->angular_v;
+                disk_general_log->pending_requests_size = volume_pending_count(&kernel->volume);
+            }
         }
     }
 }
@@ -97,65 +199,55 @@ _Noreturn void disk() {
  * @param disk_scheduler a pointer to the disk
  *                       scheduler that will be
  *                       initialized.
+ * @param id the disk number within the volume
  */
-void disk_scheduler_init(disk_scheduler_t* disk_scheduler) {
-    disk_scheduler->pending_requests = list_init();
+void disk_scheduler_init(disk_scheduler_t* disk_scheduler, int id) {
+    register int i;
+    register int j;
+
+    disk_scheduler->id = id;
+    disk_rings_init(&disk_scheduler->rings);
+
+    for (i = 0; i <= DISK_TRACK_LIMIT; i++)
+        disk_scheduler->track_requests[i] = (list_t) { NULL, NULL, 0 };
+    for (i = 0; i < DISK_TRACK_WORDS; i++)
+        disk_scheduler->pending_tracks[i] = 0;
+
+    for (i = 0; i < DISK_IOCLASS_COUNT; i++) {
+        for (j = 0; j < DISK_TRACK_WORDS; j++)
+            disk_scheduler->class_tracks[i][j] = 0;
+        disk_scheduler->class_pending[i] = 0;
+        disk_scheduler->class_served[i] = 0;
+        disk_scheduler->class_requests[i] = 0;
+        disk_scheduler->class_latency[i] = 0;
+    }
+
+    disk_scheduler->pending_count = 0;
+    pthread_mutex_init(&disk_scheduler->mutex, NULL);
+    disk_scheduler->policy = &disk_policies[DISK_POLICY];
+    disk_scheduler->clock = 0;
+    disk_scheduler->dispatch = 0;
+    disk_scheduler->trace = NULL;
+    disk_scheduler->trace_size = 0;
+    disk_scheduler->trace_capacity = 0;
+    disk_scheduler->trace_dropped = 0;
+    disk_scheduler->request_count = 0;
+    disk_scheduler->op_count = 0;
+    disk_scheduler->merged_count = 0;
+    disk_scheduler->coalesced_count = 0;
+    disk_scheduler->merge_seek_saved = 0;
+    disk_scheduler->coalesce_seek_saved = 0;
+    disk_scheduler->seek_time = 0;
+    disk_scheduler->rotation_time = 0;
+    disk_scheduler->transfer_time = 0;
+    disk_scheduler->class_boost_count = 0;
     disk_scheduler->forward_dir = 1;
     disk_scheduler->curr_track = 0;
+    disk_scheduler->angular_v = DISk_BASE_ANGULAR_V;
 }
 
 /* Disk Operation Function Prototypes */
 
-/**
- * It requests a read/write operation from the
- * disk on the specified track.
- *
- * @param process the process which request the
- *                read/write operation.
- * @param disk_scheduler the disk scheduler
- * @param track the requested track
- * @param read if is 1 indicates that the disk request
- *             is a read operation; otherwise, it indicates
- *             a write operation.
- */
-void disk_request(process_t* process, disk_scheduler_t* disk_scheduler,
-                  int track, int read) {
-    int time = DISK_OPERATION_TIME;
-
-    /* It is going from the inner track to the outer one */
-    if (disk_scheduler->forward_dir) {
-        if (track >= disk_scheduler->curr_track)
-            time += (track - disk_scheduler->curr_track) * DISK_TRACK_MOVE_TIME;
-        else
-            time += ((DISK_TRACK_LIMIT - disk_scheduler->curr_track)
-                     + (DISK_TRACK_LIMIT - track))
-                    * DISK_TRACK_MOVE_TIME;
-    }
-    /* It is going from the outer track to the inner one */
-    else {
-        if (track < disk_scheduler->curr_track)
-            time += (disk_scheduler->curr_track - track) * DISK_TRACK_MOVE_TIME;
-        else
-            time += (disk_scheduler->curr_track + track) * DISK_TRACK_MOVE_TIME;
-    }
-
-    /* It populates a disk request structure with the necessary */
-    /* information for the simulated disk handle it */
-    disk_request_t* disk_req = create_disk_request();
-    disk_req->process = process;
-    disk_req->track = track;
-    disk_req->read = read;
-    disk_req->turnaround = time;
-
-    io_disk_log(process->name, read);
-    sem_post(&io_mutex);
-
-    /* Add the disk request into the pending requests */
-    list_add(disk_scheduler->pending_requests, disk_req);
-
-    process->remaining -= time;
-}
-
 /**
  * It returns a pointer to a disk request.
  * If there is not enough memory to allocate
@@ -168,7 +260,7 @@ void disk_request(process_t* process, disk_scheduler_t* disk_scheduler,
  *         exited.
  */
 disk_request_t* create_disk_request() {
-    disk_request_t* disk_req = (disk_request_t *)malloc(sizeof(disk_request_t));
+    disk_request_t* disk_req = (disk_request_t *)slab_alloc(&disk_request_cache);
 
     /* It check if the disk request could not be allocated */
     if (!disk_req) {
@@ -179,41 +271,618 @@ disk_request_t* create_disk_request() {
     return disk_req;
 }
 
+/**
+ * It completes the specified request once its
+ * read/write operation has been performed, such
+ * that the completion of the requesting process is
+ * posted, and it releases the request.
+ *
+ * @param rings the rings of the device
+ * @param disk_req the disk request
+ */
+void disk_request_finish(disk_rings_t* rings, disk_request_t* disk_req) {
+    /* It checks if it is a mirrored write whose other */
+    /* copies have not been written yet, hence it only */
+    /* completes once the last copy is written */
+    if (disk_req->copies) {
+        if (__atomic_sub_fetch(disk_req->copies, 1, __ATOMIC_ACQ_REL) > 0) {
+            slab_free(&disk_request_cache, disk_req);
+            return;
+        }
+
+        free(disk_req->copies);
+    }
+
+    /* It checks if it is a read-ahead or a write-back of the buffer */
+    /* cache, whose buffer is clean once written, or a journal write */
+    if (!disk_req->process) {
+        if (!disk_req->read && !disk_req->journal)
+            buffer_cache_clean(&kernel->buffer_cache, disk_req->block);
+        slab_free(&disk_request_cache, disk_req);
+        return;
+    }
+
+    disk_log(disk_req->process->name, disk_req->process->id, disk_req->track, disk_req->read, disk_req->turnaround);
+    sem_post(&disk_mutex);
+
+    io_fs_log(disk_req->process->name, INODE_NUMBER(disk_req->block),
+              disk_req->read ? IO_LOG_FS_READ : IO_LOG_FS_WRITE);
+    sem_post(&io_mutex);
+
+    /* After perform the disk read/write operation the */
+    /* completion is posted to the kernel, which emits */
+    /* the interrupt signal once it reaps it */
+    disk_complete(rings, disk_req->process, disk_req->turnaround, disk_req->async);
+
+    slab_free(&disk_request_cache, disk_req);
+}
+
+/**
+ * It detects the process reading tracks sequentially
+ * and, if so, it requests the following tracks to be
+ * read ahead into the buffer cache. The amount of
+ * tracks read ahead doubles while the process keeps
+ * reading sequentially.
+ *
+ * @param process the process which has requested a read
+ * @param volume the volume
+ * @param track the (logical) track being read
+ */
+void disk_read_ahead(process_t* process, volume_t* volume, int track) {
+    int last;
+    int next;
+
+    /* It checks if the process is reading sequentially */
+    if (track == process->last_read + 1)
+        process->ra_window = process->ra_window ? MIN(process->ra_window << 1, BUFFER_READ_AHEAD_MAX) : 1;
+    else {
+        process->ra_window = 0;
+        process->ra_next = 0;
+    }
+
+    process->last_read = track;
+    last = MIN(track + process->ra_window, DISK_TRACK_LIMIT);
+
+    /* The tracks already read ahead are not requested again */
+    for (next = MAX(track + 1, process->ra_next); next <= last; next++)
+        if (buffer_cache_read_ahead(&kernel->buffer_cache, DISK_BLOCK(next)))
+            volume_request(NULL, volume, next, 1, 0, DISK_PRODUCER_KERNEL);
+
+    process->ra_next = MAX(process->ra_next, last + 1);
+}
+
+/**
+ * It prints the merging and the coalescing
+ * statistics of the disk scheduler.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param fp the file to be printed to
+ */
+void disk_scheduler_report(disk_scheduler_t* disk_scheduler, FILE* fp) {
+    pthread_mutex_lock(&disk_scheduler->mutex);
+
+    /* A merged request avoids the rotation and the transfer of */
+    /* a whole disk operation, besides the seek to its track, */
+    /* whereas a coalesced track avoids the settle of the head */
+    const long access_time = disk_scheduler->rotation_time + disk_scheduler->transfer_time;
+    fprintf(fp, "Disk %d: %ld requests served by %ld operations (merge ratio %.2lf), "
+                "%ld merged, %ld tracks coalesced, %ld u.t. of access saved by merging\n",
+            disk_scheduler->id, disk_scheduler->request_count, disk_scheduler->op_count,
+            disk_scheduler->op_count > 0 ? (double) disk_scheduler->request_count / disk_scheduler->op_count : 0.0,
+            disk_scheduler->merged_count, disk_scheduler->coalesced_count,
+            disk_scheduler->op_count > 0 ? disk_scheduler->merged_count * access_time / disk_scheduler->op_count : 0);
+    fprintf(fp, "Disk %d: %ld u.t. of seeking saved by merging, %ld u.t. saved by coalescing\n",
+            disk_scheduler->id, disk_scheduler->merge_seek_saved, disk_scheduler->coalesce_seek_saved);
+    fprintf(fp, "Disk %d: %ld u.t. seeking, %ld u.t. rotating, %ld u.t. transferring\n",
+            disk_scheduler->id, disk_scheduler->seek_time,
+            disk_scheduler->rotation_time, disk_scheduler->transfer_time);
+    fprintf(fp, "Disk %d: RT %ld requests (mean latency %.1lf u.t.), BE %ld requests (mean latency %.1lf u.t.), "
+                "IDLE %ld requests (mean latency %.1lf u.t.), %ld starved class boosts\n",
+            disk_scheduler->id,
+            DISK_IOCLASS_STATS(disk_scheduler, DISK_IOCLASS_RT),
+            DISK_IOCLASS_STATS(disk_scheduler, DISK_IOCLASS_BE),
+            DISK_IOCLASS_STATS(disk_scheduler, DISK_IOCLASS_IDLE),
+            disk_scheduler->class_boost_count);
+
+    pthread_mutex_unlock(&disk_scheduler->mutex);
+}
+
+/* Disk Ring Function Definitions */
+
+/**
+ * It initializes the rings of a device.
+ *
+ * @param rings the rings
+ */
+void disk_rings_init(disk_rings_t* rings) {
+    register int i;
+
+    for (i = 0; i < DISK_PRODUCER_COUNT; i++)
+        ring_init(&rings->submissions[i], DISK_RING_SIZE, sizeof(disk_sqe_t));
+    ring_init(&rings->completions, DISK_RING_SIZE, sizeof(disk_cqe_t));
+
+    rings->overflow = (list_t) { NULL, NULL, 0 };
+    rings->reaped_count = 0;
+    rings->reap_count = 0;
+}
+
+/**
+ * It stages a request into the submission ring of
+ * the specified producer. It is seen by the device
+ * once the producer publishes its submissions.
+ *
+ * @param rings the rings of the device
+ * @param producer the submitting thread
+ * @param sqe the request
+ */
+void disk_submit(disk_rings_t* rings, disk_producer_t producer, const disk_sqe_t* sqe) {
+    /* A full ring is published, such that the device drains it */
+    ring_push_wait(&rings->submissions[producer], sqe);
+}
+
+/**
+ * It publishes every request staged by
+ * the specified producer at once.
+ *
+ * @param rings the rings of the device
+ * @param producer the submitting thread
+ */
+void disk_submit_publish(disk_rings_t* rings, disk_producer_t producer) {
+    ring_publish(&rings->submissions[producer]);
+}
+
+/**
+ * It takes the submitted requests of every producer.
+ * It is supposed to be invoked by the device thread.
+ *
+ * @param rings the rings of the device
+ * @param sqes an array (of DISK_RING_BATCH size)
+ *             to receive the requests
+ * @param producer the producer whose requests are taken
+ *
+ * @return the amount of requests taken
+ */
+int disk_submit_take(disk_rings_t* rings, disk_sqe_t* sqes, disk_producer_t producer) {
+    return ring_pop(&rings->submissions[producer], sqes, DISK_RING_BATCH);
+}
+
+/**
+ * It stages the completion of the specified process.
+ * It is supposed to be invoked by the device thread.
+ *
+ * @param rings the rings of the device
+ * @param process the process to be unblocked
+ * @param turnaround the time (u.t.) the process
+ *                   is charged for the operation
+ * @param async if is 1 indicates that the process
+ *              has kept running meanwhile
+ */
+void disk_complete(disk_rings_t* rings, process_t* process, int turnaround, int async) {
+    const disk_cqe_t cqe = { process, turnaround, async };
+    disk_cqe_t* pending;
+
+    /* The device never waits for the kernel, hence the completions */
+    /* that do not fit are kept in order until there is room */
+    if (rings->overflow.size == 0 && ring_push(&rings->completions, &cqe))
+        return;
+
+    /* It checks if the pending completion could not be allocated */
+    if (!(pending = (disk_cqe_t *)malloc(sizeof(disk_cqe_t)))) {
+        printf("Not enough memory to allocate a disk completion.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    *pending = cqe;
+    list_add(&rings->overflow, pending);
+}
+
+/**
+ * It publishes every staged completion at once.
+ * It is supposed to be invoked by the device thread.
+ *
+ * @param rings the rings of the device
+ */
+void disk_complete_publish(disk_rings_t* rings) {
+    list_node_t* node;
+
+    while (rings->overflow.size > 0 && ring_push(&rings->completions, rings->overflow.head->content)) {
+        node = list_remove_head(&rings->overflow);
+        free(node->content);
+        list_node_free(node);
+    }
+
+    ring_publish(&rings->completions);
+}
+
+/**
+ * It reaps every published completion, such that each
+ * process is charged for its operation and unblocked,
+ * or, if the operation is asynchronous, such that the
+ * process is signaled. It is supposed to be invoked by
+ * the kernel.
+ *
+ * @param rings the rings of the device
+ *
+ * @return the amount of reaped completions
+ */
+int disk_reap(disk_rings_t* rings) {
+    disk_cqe_t cqes[DISK_RING_BATCH];
+    int reaped = 0;
+    int count;
+    register int i;
+
+    while ((count = ring_pop(&rings->completions, cqes, DISK_RING_BATCH)) > 0) {
+        for (i = 0; i < count; i++) {
+            /* The process has overlapped the asynchronous operation */
+            /* with its own work, hence it is not charged for it */
+            if (cqes[i].async) {
+                interruptControl(DISK_AIO_FINISH, cqes[i].process);
+                continue;
+            }
+
+            cqes[i].process->remaining -= cqes[i].turnaround;
+            interruptControl(DISK_FINISH, cqes[i].process);
+        }
+        reaped += count;
+    }
+
+    if (reaped > 0) {
+        rings->reaped_count += reaped;
+        rings->reap_count++;
+    }
+
+    return reaped;
+}
+
 /* Internal Disk Function Definitions */
 
+/**
+ * It moves the disk arm straight to the next track
+ * chosen by the disk scheduling policy. Further, if
+ * there is no pending request at all, the arm stays
+ * on the current track.
+ *
+ * @param disk_scheduler the disk scheduler
+ *
+ * @return 1 if the arm has moved to an adjacent
+ *         track, which is served in the same sweep
+ *         segment; otherwise, 0 is returned.
+ */
+static int disk_arm_move(disk_scheduler_t* disk_scheduler) {
+    int coalesced = 0;
+    int next;
+
+    pthread_mutex_lock(&disk_scheduler->mutex);
+
+    /* The clock is advanced by the seek along the seek curve */
+    /* or, if the arm stays idle, by a whole disk tick */
+    disk_scheduler->dispatch = disk_scheduler->clock;
+    if ((next = disk_ioclass_next_track(disk_scheduler)) >= 0) {
+        long seek = disk_seek_time(abs(next - disk_scheduler->curr_track));
+
+        /* The adjacent track is coalesced only if the policy */
+        /* chooses it, such that the I/O classes and the */
+        /* deadlines are honoured as for any other track. It */
+        /* is reached within the sweep, without settling again */
+        if ((coalesced = abs(next - disk_scheduler->curr_track) == 1)) {
+            seek -= DISK_SEEK_SETTLE_TIME;
+            disk_scheduler->coalesced_count++;
+            disk_scheduler->coalesce_seek_saved += DISK_SEEK_SETTLE_TIME;
+        }
+
+        disk_scheduler->clock += seek;
+        disk_scheduler->seek_time += seek;
+        disk_scheduler->curr_track = next;
+    } else disk_scheduler->dispatch = disk_scheduler->clock += DISK_TRACK_MOVE_TIME;
+
+    pthread_mutex_unlock(&disk_scheduler->mutex);
+    return coalesced;
+}
+
+/**
+ * It returns the next track chosen by the disk
+ * scheduling policy among the tracks pending in the
+ * highest I/O class having pending requests, unless
+ * a lower class has waited longer than its bound,
+ * which is served instead. If there is no pending
+ * request, then -1 is returned. It is supposed that
+ * the disk scheduler mutex is held.
+ *
+ * @param disk_scheduler the disk scheduler
+ */
+static int disk_ioclass_next_track(disk_scheduler_t* disk_scheduler) {
+    static const long class_wait[DISK_IOCLASS_COUNT] = { 0, DISK_IOCLASS_BE_WAIT, DISK_IOCLASS_IDLE_WAIT };
+    unsigned long pending_tracks[DISK_TRACK_WORDS];
+    int ioclass = -1;
+    int next;
+    register int i;
+
+    for (i = 0; i < DISK_IOCLASS_COUNT; i++) {
+        if (disk_scheduler->class_pending[i] == 0)
+            continue;
+
+        /* The highest pending class is served, unless a lower one starves */
+        if (ioclass < 0)
+            ioclass = i;
+        else if (disk_scheduler->clock - disk_scheduler->class_served[i] >= class_wait[i]) {
+            ioclass = i;
+            disk_scheduler->class_boost_count++;
+            break;
+        }
+    }
+
+    if (ioclass < 0)
+        return -1;
+
+    /* The policy only sees the tracks pending in the served class */
+    memcpy(pending_tracks, disk_scheduler->pending_tracks, sizeof(pending_tracks));
+    memcpy(disk_scheduler->pending_tracks, disk_scheduler->class_tracks[ioclass], sizeof(pending_tracks));
+    next = disk_scheduler->policy->next_track(disk_scheduler);
+    memcpy(disk_scheduler->pending_tracks, pending_tracks, sizeof(pending_tracks));
+
+    disk_scheduler->class_served[ioclass] = disk_scheduler->clock;
+    return next;
+}
+
+/**
+ * It queues the submitted request into its track
+ * pending requests, merging it into a pending
+ * operation if possible. It is supposed that the
+ * disk scheduler mutex is held.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param sqe the submitted request
+ */
+static void disk_enqueue(disk_scheduler_t* disk_scheduler, const disk_sqe_t* sqe) {
+    disk_request_t* disk_req = create_disk_request();
+    const int track = sqe->track;
+    const int read = sqe->read;
+
+    /* It populates a disk request structure with the necessary */
+    /* information for the simulated disk handle it. The time */
+    /* is known once the request is served (see rw_disk_op_resolve) */
+    disk_req->process = sqe->process;
+    disk_req->track = track;
+    disk_req->block = sqe->block;
+    disk_req->async = sqe->async;
+    disk_req->ioclass = sqe->ioclass;
+    disk_req->sector = disk_sector(sqe->block);
+    disk_req->sectors = DISK_REQUEST_SECTORS;
+    disk_req->read = read;
+    disk_req->turnaround = 0;
+    disk_req->arrival = disk_scheduler->clock;
+    disk_req->merged = NULL;
+    disk_req->fanout = 1;
+    disk_req->copies = sqe->copies;
+    disk_req->journal = sqe->journal;
+    disk_trace_add(disk_scheduler, disk_req);
+
+    /* It searches for a pending operation in the same track and */
+    /* direction into which the request is merged, such that the */
+    /* journal writes are only merged with each other */
+    disk_request_t* op = NULL;
+    list_node_t* op_node;
+    for (op_node = disk_scheduler->track_requests[track].head; op_node != NULL; op_node = op_node->next)
+        if (((disk_request_t *)op_node->content)->read == read
+            && ((disk_request_t *)op_node->content)->journal == disk_req->journal) {
+            op = (disk_request_t *)op_node->content;
+            break;
+        }
+
+    if (op) {
+        disk_req->merged = op->merged;
+        op->merged = disk_req;
+        op->fanout++;
+        disk_scheduler->merged_count++;
+        disk_scheduler->merge_seek_saved += disk_seek_time(abs(track - disk_scheduler->curr_track));
+    } else {
+        /* Add the disk request into its track pending requests */
+        list_add(&disk_scheduler->track_requests[track], disk_req);
+        disk_scheduler->pending_tracks[track / DISK_TRACK_WORD_BITS] |= 1UL << (track % DISK_TRACK_WORD_BITS);
+        disk_scheduler->op_count++;
+    }
+
+    /* The track is pending in the request class even if it */
+    /* has been merged into an operation of another class */
+    if (disk_scheduler->class_pending[disk_req->ioclass]++ == 0)
+        disk_scheduler->class_served[disk_req->ioclass] = disk_scheduler->clock;
+    disk_scheduler->class_tracks[disk_req->ioclass][track / DISK_TRACK_WORD_BITS]
+        |= 1UL << (track % DISK_TRACK_WORD_BITS);
+
+    disk_scheduler->pending_count++;
+    disk_scheduler->request_count++;
+}
+
+/**
+ * It takes the requests submitted by every producer
+ * and it queues them into the disk scheduler.
+ *
+ * @param disk_scheduler the disk scheduler
+ */
+static void disk_drain(disk_scheduler_t* disk_scheduler) {
+    disk_sqe_t sqes[DISK_RING_BATCH];
+    int producer;
+    int count;
+    register int i;
+
+    for (producer = 0; producer < DISK_PRODUCER_COUNT; producer++)
+        while ((count = disk_submit_take(&disk_scheduler->rings, sqes, producer)) > 0) {
+            /* A whole batch is queued under a single lock acquisition */
+            pthread_mutex_lock(&disk_scheduler->mutex);
+            for (i = 0; i < count; i++)
+                disk_enqueue(disk_scheduler, &sqes[i]);
+            pthread_mutex_unlock(&disk_scheduler->mutex);
+        }
+}
+
+/**
+ * It records the disk request in the disk trace.
+ * If the trace has reached DISK_TRACE_LIMIT, then
+ * the request is only counted. It is supposed that
+ * the disk scheduler mutex is held.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param disk_req the disk request
+ */
+static void disk_trace_add(disk_scheduler_t* disk_scheduler, const disk_request_t* disk_req) {
+    if (disk_scheduler->trace_size == DISK_TRACE_LIMIT) {
+        disk_scheduler->trace_dropped++;
+        return;
+    }
+
+    /* It checks if the disk trace is full, hence it is grown */
+    if (disk_scheduler->trace_size == disk_scheduler->trace_capacity) {
+        const int capacity = disk_scheduler->trace_capacity
+                             ? MIN(disk_scheduler->trace_capacity << 1, DISK_TRACE_LIMIT) : 64;
+        disk_trace_entry_t* trace = (disk_trace_entry_t *)realloc(disk_scheduler->trace,
+                                                                  sizeof(disk_trace_entry_t) * capacity);
+
+        /* It checks if the disk trace could not be grown */
+        if (!trace) {
+            printf("Not enough memory to record a disk request.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        disk_scheduler->trace = trace;
+        disk_scheduler->trace_capacity = capacity;
+    }
+
+    disk_scheduler->trace[disk_scheduler->trace_size++]
+        = (disk_trace_entry_t) { disk_req->arrival, disk_req->track, disk_req->sector };
+}
+
 /**
  * It performs the read/write operation for
  * those pending requests that are over the
  * specified track.
  *
+ * @param disk_scheduler the disk scheduler
  * @param track the specified track
  */
-static void rw_disk_op_resolve(int track) {
+static void rw_disk_op_resolve(disk_scheduler_t* disk_scheduler, int track) {
     list_node_t* curr_node;
-    list_node_t* next_node;
+    list_node_t* op_node;
+    disk_request_t* next_req;
+    disk_request_t* merged;
+    process_t* sync_proc;
+    list_t requests;
+    register int i;
+
+    /* It takes every pending operation for that track at once, */
+    /* such that they are resolved without holding the mutex */
+    pthread_mutex_lock(&disk_scheduler->mutex);
+    requests = disk_scheduler->track_requests[track];
+    disk_scheduler->track_requests[track] = (list_t) { NULL, NULL, 0 };
+    disk_scheduler->pending_tracks[track / DISK_TRACK_WORD_BITS] &= ~(1UL << (track % DISK_TRACK_WORD_BITS));
+    for (i = 0; i < DISK_IOCLASS_COUNT; i++)
+        disk_scheduler->class_tracks[i][track / DISK_TRACK_WORD_BITS] &= ~(1UL << (track % DISK_TRACK_WORD_BITS));
+    for (op_node = requests.head; op_node != NULL; op_node = op_node->next) {
+        disk_request_t* op = (disk_request_t *)op_node->content;
+        const long rotation = disk_rotational_latency(disk_scheduler->angular_v, disk_scheduler->clock, op->sector);
+        const long transfer = disk_transfer_time(disk_scheduler->angular_v, op->sectors);
+
+        /* Each operation waits for its sectors to rotate under the head */
+        disk_scheduler->clock += rotation + transfer;
+        disk_scheduler->rotation_time += rotation;
+        disk_scheduler->transfer_time += transfer;
+        disk_scheduler->pending_count -= op->fanout;
+
+        /* Every request merged into the operation is accounted in its */
+        /* class. A request is served from the dispatch of the operation */
+        /* (including the seek of the first one) or from its arrival, and */
+        /* the process is charged for the whole time it has taken */
+        for (merged = op; merged != NULL; merged = merged->merged) {
+            const long start = MAX(disk_scheduler->dispatch, merged->arrival);
+
+            merged->turnaround = (int) (disk_scheduler->clock - merged->arrival);
+
+            disk_scheduler->class_pending[merged->ioclass]--;
+            disk_scheduler->class_requests[merged->ioclass]++;
+            disk_scheduler->class_latency[merged->ioclass] += disk_scheduler->clock - merged->arrival;
+            volume_record(&kernel->volume, merged, start - merged->arrival, disk_scheduler->clock - start);
+        }
 
-    for (curr_node = kernel->disk_scheduler.pending_requests->head;
-         curr_node != NULL;) {
-        next_node = curr_node->next;
+        disk_scheduler->dispatch = disk_scheduler->clock;
+    }
+    pthread_mutex_unlock(&disk_scheduler->mutex);
+
+    while ((curr_node = list_remove_head(&requests))) {
         disk_request_t* disk_req = (disk_request_t *)curr_node->content;
 
-        /* It check if that pending requests is for that track */
-        /* If so, then resolve its read/write disk operation */
-        if (disk_req->track == track) {
-            disk_log(disk_req->process->name, disk_req->process->id, track, disk_req->read, disk_req->turnaround);
-            sem_post(&disk_mutex);
+        /* The operation transfers its sectors from/to the backing image */
+        disk_image_io(&kernel->volume.image, disk_scheduler->id, track, disk_req->block,
+                      disk_req->sector, disk_req->sectors, disk_req->read);
 
-            io_fs_log(disk_req->process->name, INODE_NUMBER(DISK_BLOCK(track)),
-                      disk_req->read ? IO_LOG_FS_READ : IO_LOG_FS_WRITE);
-            sem_post(&io_mutex);
+        /* The transferred block is kept in the buffer cache. It has */
+        /* been read ahead if no process has requested it meanwhile */
+        if (!disk_req->journal)
+            buffer_cache_fill(&kernel->buffer_cache, disk_req->block,
+                              !disk_req->process && disk_req->read && disk_req->fanout == 1);
 
-            /* After perform the disk read/write operation */
-            /* emit a interrupt signal */
-            interruptControl(DISK_FINISH, disk_req->process);
+        /* The operation completes every request merged into it */
+        for (; disk_req != NULL; disk_req = next_req) {
+            next_req = disk_req->merged;
+            disk_request_finish(&disk_scheduler->rings, disk_req);
+        }
 
-            list_remove_node(kernel->disk_scheduler.pending_requests, curr_node);
+        list_node_free(curr_node);
+    }
+
+    /* It signals the processes whose writes have become durable */
+    while ((sync_proc = (process_t *)buffer_cache_sync_done(&kernel->buffer_cache)))
+        disk_complete(&disk_scheduler->rings, sync_proc, 0, 0);
+}
+
+/**
+ * It compares two blocks by their track.
+ */
+static int block_cmp(const void* b1, const void* b2) {
+    return *(const int *)b1 - *(const int *)b2;
+}
+
+/**
+ * It represents the function that is going to
+ * write the dirty buffers of the buffer cache
+ * back to the disk.
+ */
+_Noreturn static void disk_flusher() {
+    int* blocks = (int *)malloc(sizeof(int) * kernel->buffer_cache.capacity);
+    volume_t* volume = &kernel->volume;
+    int count;
+    int first;
+    int head;
+    register int i;
+
+    /* It checks if the flushed blocks could not be allocated */
+    if (!blocks) {
+        printf("Not enough memory to allocate the flushed blocks.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while (1) {
+        count = buffer_cache_flush_wait(&kernel->buffer_cache, blocks);
+
+        /* The blocks are written in elevator order, that is, from the */
+        /* arm of the first disk towards its direction and back. Since */
+        /* the volume keeps the track order on every disk, the other */
+        /* disks receive their blocks in ascending/descending order */
+        qsort(blocks, count, sizeof(int), block_cmp);
+        head = volume_head(volume);
+        for (first = 0; first < count && INVERSE_DISK_BLOCK(blocks[first]) < head; first++);
+
+        if (volume->disks[0].forward_dir) {
+            for (i = first; i < count; i++)
+                volume_request(NULL, volume, INVERSE_DISK_BLOCK(blocks[i]), 0, 0, DISK_PRODUCER_FLUSHER);
+            for (i = first - 1; i >= 0; i--)
+                volume_request(NULL, volume, INVERSE_DISK_BLOCK(blocks[i]), 0, 0, DISK_PRODUCER_FLUSHER);
+        } else {
+            for (i = first - 1; i >= 0; i--)
+                volume_request(NULL, volume, INVERSE_DISK_BLOCK(blocks[i]), 0, 0, DISK_PRODUCER_FLUSHER);
+            for (i = first; i < count; i++)
+                volume_request(NULL, volume, INVERSE_DISK_BLOCK(blocks[i]), 0, 0, DISK_PRODUCER_FLUSHER);
         }
 
-        curr_node = next_node;
+        /* The whole flush is submitted at once */
+        volume_submit(volume, DISK_PRODUCER_FLUSHER);
     }
 }
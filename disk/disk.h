@@ -1,8 +1,12 @@
 #ifndef OS_PROJECT_DISK_H
 #define OS_PROJECT_DISK_H
 
+#include <pthread.h>
+
 #include "../tools/list.h"
+#include "../tools/ring.h"
 #include "../process/process.h"
+#include "ioclass.h"
 
 #define DISK_BLOCK(track) ((track) * 521 + 8)
 #define INVERSE_DISK_BLOCK(block) (((block) - 8) / 521)
@@ -21,15 +25,232 @@
  */
 #define DISK_TRACK_LIMIT (200)
 
+/**
+ * It represents the mean time (u.t.) of a disk
+ * operation and the time (u.t.) of a disk tick
+ * in which the arm stays idle. The operations
+ * are timed by the disk timing model instead.
+ */
 #define DISK_OPERATION_TIME (5000)
 #define DISK_TRACK_MOVE_TIME (100)
 
+/**
+ * It represents the amount of words of the
+ * bitmap holding the tracks with pending
+ * requests.
+ */
+#define DISK_TRACK_WORD_BITS (8 * sizeof(unsigned long))
+#define DISK_TRACK_WORDS ((int) ((DISK_TRACK_LIMIT + DISK_TRACK_WORD_BITS) / DISK_TRACK_WORD_BITS))
+
+/**
+ * It represents the amount of entries of each
+ * submission ring and of the completion ring.
+ */
+#define DISK_RING_SIZE (256)
+
+/**
+ * It represents the maximum amount of entries
+ * taken from a ring at once.
+ */
+#define DISK_RING_BATCH (32)
+
+/**
+ * It represents the maximum amount of requests
+ * recorded in the disk trace, past which they
+ * are only counted.
+ */
+#define DISK_TRACE_LIMIT (64 * 1024)
+
+/**
+ * It represents the maximum time (u.t.) the pending
+ * requests of the best-effort and of the idle I/O
+ * classes wait while a higher class is served, before
+ * their class is served ahead of it.
+ */
+#define DISK_IOCLASS_BE_WAIT (50000)
+#define DISK_IOCLASS_IDLE_WAIT (200000)
+
+struct DiskPolicy;
+struct Volume;
+
+/**
+ * It represents the threads submitting disk
+ * requests, each of them owning a submission
+ * ring on every device.
+ */
+typedef enum DiskProducer {
+    DISK_PRODUCER_KERNEL,
+    DISK_PRODUCER_FLUSHER,
+    DISK_PRODUCER_COUNT
+} disk_producer_t;
+
+/**
+ * It represents a request submitted to a device.
+ */
+typedef struct DiskSqe {
+    /**
+     * It holds the requesting process or NULL
+     * if it is a request of the buffer cache.
+     */
+    process_t* process;
+
+    /**
+     * It holds the device track (page) and
+     * the (logical) block of the volume.
+     */
+    int track;
+    int block;
+
+    /**
+     * It is 1 if it is a read operation;
+     * otherwise, it is a write operation.
+     */
+    int read;
+
+    /**
+     * It is 1 if the process keeps running
+     * while the operation is performed.
+     */
+    int async;
+
+    /**
+     * It holds the I/O class of the request.
+     */
+    disk_ioclass_t ioclass;
+
+    /**
+     * It points to the amount of copies of a
+     * mirrored write not completed yet, followed
+     * by the amount not recorded yet, or NULL.
+     */
+    int* copies;
+
+    /**
+     * It is 1 if it is a write of the file
+     * system journal (see volume_journal_request).
+     */
+    int journal;
+} disk_sqe_t;
+
+/**
+ * It represents a request completed by a device.
+ */
+typedef struct DiskCqe {
+    /**
+     * It holds the process to be unblocked and
+     * the time (u.t.) it is charged for the
+     * operation.
+     */
+    process_t* process;
+    int turnaround;
+
+    /**
+     * It is 1 if the process has kept running
+     * while the operation was performed, hence
+     * it is neither charged nor unblocked.
+     */
+    int async;
+} disk_cqe_t;
+
+/**
+ * It represents the rings shared by a device and
+ * the threads using it. Each producer submits into
+ * its own ring, which is only drained by the device
+ * thread, whereas the device thread posts into the
+ * completion ring, which is only reaped by the kernel.
+ */
+typedef struct DiskRings {
+    /**
+     * It holds the submission rings, indexed
+     * by producer, and the completion ring.
+     */
+    ring_t submissions[DISK_PRODUCER_COUNT];
+    ring_t completions;
+
+    /**
+     * It holds the completions that did not fit
+     * into the completion ring. It is only handled
+     * by the device thread.
+     */
+    list_t overflow;
+
+    /**
+     * It holds the amount of reaped completions
+     * and the amount of reaps that found some.
+     */
+    long reaped_count;
+    long reap_count;
+} disk_rings_t;
+
+/**
+ * It represents a disk request recorded
+ * in the disk trace, such that the request
+ * stream may be replayed afterwards.
+ */
+typedef struct DiskTraceEntry {
+    /**
+     * It holds the time (u.t.) in which
+     * the request has arrived.
+     */
+    long arrival;
+
+    /**
+     * It holds the requested track and
+     * the sector the request starts at.
+     */
+    int track;
+    int sector;
+} disk_trace_entry_t;
+
 typedef struct DiskScheduler {
     /**
-     * It represents a linked list
-     * containing the pending requests.
+     * It holds the disk number
+     * within the volume.
+     */
+    int id;
+
+    /**
+     * It holds the rings through which the
+     * requests are submitted and completed.
+     */
+    disk_rings_t rings;
+
+    /**
+     * It represents the pending requests
+     * indexed by their track.
+     */
+    list_t track_requests[DISK_TRACK_LIMIT + 1];
+
+    /**
+     * It represents the sorted set of the
+     * tracks having pending requests, such
+     * that the i-th bit is set if the i-th
+     * track has some pending request.
+     */
+    unsigned long pending_tracks[DISK_TRACK_WORDS];
+
+    /**
+     * It holds the tracks having pending requests
+     * of each I/O class, the amount of pending
+     * requests of each class and the clock (u.t.)
+     * when each class was last served or, if it
+     * had nothing pending, when it got a request.
+     */
+    unsigned long class_tracks[DISK_IOCLASS_COUNT][DISK_TRACK_WORDS];
+    int class_pending[DISK_IOCLASS_COUNT];
+    long class_served[DISK_IOCLASS_COUNT];
+
+    /**
+     * It stores the amount of
+     * pending requests.
+     */
+    int pending_count;
+
+    /**
+     * It ensures mutual exclusion when
+     * handling the pending requests.
      */
-    list_t* pending_requests;
+    pthread_mutex_t mutex;
 
     /**
      * If it is true, then the disk arm
@@ -48,6 +269,85 @@ typedef struct DiskScheduler {
      * It stores the disk angular velocity.
      */
     int angular_v;
+
+    /**
+     * It points to the policy choosing
+     * the next track to be served.
+     */
+    const struct DiskPolicy* policy;
+
+    /**
+     * It holds the disk clock (u.t.), that
+     * is advanced as the disk arm moves.
+     */
+    long clock;
+
+    /**
+     * It holds the clock (u.t.) when the disk
+     * has started serving the next operation,
+     * that is, before the arm has moved to it.
+     */
+    long dispatch;
+
+    /**
+     * It holds the requests that have been made
+     * to the disk in arrival order, up to the
+     * DISK_TRACE_LIMIT first ones, and the amount
+     * of those that have not been recorded.
+     */
+    disk_trace_entry_t* trace;
+    int trace_size;
+    int trace_capacity;
+    long trace_dropped;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of requests and
+     * the amount of physical operations that
+     * have been issued to serve them.
+     */
+    long request_count;
+    long op_count;
+
+    /**
+     * It holds the amount of requests merged
+     * into a pending operation and the amount
+     * of tracks served in the same sweep segment
+     * as the previous one (without an arm seek).
+     */
+    long merged_count;
+    long coalesced_count;
+
+    /**
+     * It holds the seek time (u.t.) the merged
+     * requests have avoided, that is, the seek
+     * from the arm to their track, and the one
+     * the coalesced tracks have avoided, that is,
+     * the settle of the head on each of them.
+     */
+    long merge_seek_saved;
+    long coalesce_seek_saved;
+
+    /**
+     * It holds the time (u.t.) the disk has
+     * spent seeking, waiting for the sectors
+     * to rotate under the head and transferring
+     * them, respectively.
+     */
+    long seek_time;
+    long rotation_time;
+    long transfer_time;
+
+    /**
+     * It holds the amount of served requests and
+     * the sum of their latencies (u.t.) for each
+     * I/O class, and the amount of times a class
+     * has been served ahead of a higher one.
+     */
+    long class_requests[DISK_IOCLASS_COUNT];
+    long class_latency[DISK_IOCLASS_COUNT];
+    long class_boost_count;
 } disk_scheduler_t;
 
 typedef struct DiskRequest {
@@ -64,6 +364,19 @@ typedef struct DiskRequest {
      */
     int track;
 
+    /**
+     * It holds the (logical) block of the
+     * volume the track is mapped from.
+     */
+    int block;
+
+    /**
+     * It holds the sector the request starts
+     * at and the amount of sectors transferred.
+     */
+    int sector;
+    int sectors;
+
     /**
      * It indicates that this request
      * is a read operation since this
@@ -73,23 +386,71 @@ typedef struct DiskRequest {
      */
     int read;
 
+    /**
+     * It indicates that the process keeps
+     * running while the operation is
+     * performed (see aread).
+     */
+    int async;
+
+    /**
+     * It holds the I/O class the
+     * request is served in.
+     */
+    disk_ioclass_t ioclass;
+
     /**
      * It stores the amount of time
-     * that the disk will take to
+     * that the disk has taken to
      * complete the read/write
-     * operation.
+     * operation since its arrival.
      */
     int turnaround;
+
+    /**
+     * It holds the disk clock (u.t.)
+     * when the request has arrived.
+     */
+    long arrival;
+
+    /**
+     * It points to the next request that has
+     * been merged into the same operation, such
+     * that all of them complete together, and it
+     * holds the amount of requests served by the
+     * operation (only meaningful on its first
+     * request).
+     */
+    struct DiskRequest* merged;
+    int fanout;
+
+    /**
+     * It points to the amount of copies of a
+     * mirrored write that have not completed
+     * yet, followed by the amount of them that
+     * have not been recorded yet (see
+     * volume_record), shared by every copy, or
+     * it is NULL if the request has a single copy.
+     */
+    int* copies;
+
+    /**
+     * It is 1 if it is a write of the file system
+     * journal, which is neither merged with the other
+     * requests nor cached, nor accounted to its track.
+     */
+    int journal;
 } disk_request_t;
 
 /* Disk Function Prototypes */
 
 /**
- * It creates the DiskScheduler-Thread that
- * is going to run the Hard Disk function
- * that is going to simulate the hard
- * disk work along the operating system
- * simulation.
+ * It creates a DiskScheduler-Thread for each
+ * disk of the volume that is going to run the
+ * Hard Disk function that is going to simulate
+ * the hard disk work along the operating system
+ * simulation. If the volume is backed by the
+ * flash device, then a single thread runs it.
  */
 void disk_init();
 
@@ -99,8 +460,11 @@ void disk_init();
  * disk work by moving its arm
  * over the disk surface making
  * reading and writing.
+ *
+ * @param disk_scheduler the scheduler of
+ *                       the simulated disk
  */
-_Noreturn void disk();
+_Noreturn void disk(disk_scheduler_t* disk_scheduler);
 
 /* Disk Scheduler Function Prototypes */
 
@@ -110,8 +474,9 @@ _Noreturn void disk();
  * @param disk_scheduler a pointer to the disk
  *                       scheduler that will be
  *                       initialized.
+ * @param id the disk number within the volume
  */
-void disk_scheduler_init(disk_scheduler_t *disk_scheduler);
+void disk_scheduler_init(disk_scheduler_t *disk_scheduler, int id);
 
 /* Disk Operation Function Prototypes */
 
@@ -129,17 +494,112 @@ void disk_scheduler_init(disk_scheduler_t *disk_scheduler);
 disk_request_t* create_disk_request();
 
 /**
- * It requests a read/write operation from the
- * disk on the specified track.
+ * It completes the specified request once its
+ * read/write operation has been performed, such
+ * that the completion of the requesting process is
+ * posted, and it releases the request.
+ *
+ * @param rings the rings of the device
+ * @param disk_req the disk request
+ */
+void disk_request_finish(disk_rings_t* rings, disk_request_t* disk_req);
+
+/* Disk Ring Function Prototypes */
+
+/**
+ * It initializes the rings of a device.
+ *
+ * @param rings the rings
+ */
+void disk_rings_init(disk_rings_t* rings);
+
+/**
+ * It stages a request into the submission ring of
+ * the specified producer. It is seen by the device
+ * once the producer publishes its submissions.
+ *
+ * @param rings the rings of the device
+ * @param producer the submitting thread
+ * @param sqe the request
+ */
+void disk_submit(disk_rings_t* rings, disk_producer_t producer, const disk_sqe_t* sqe);
+
+/**
+ * It publishes every request staged by
+ * the specified producer at once.
+ *
+ * @param rings the rings of the device
+ * @param producer the submitting thread
+ */
+void disk_submit_publish(disk_rings_t* rings, disk_producer_t producer);
+
+/**
+ * It takes the submitted requests of every producer.
+ * It is supposed to be invoked by the device thread.
+ *
+ * @param rings the rings of the device
+ * @param sqes an array (of DISK_RING_BATCH size)
+ *             to receive the requests
+ * @param producer the producer whose requests are taken
+ *
+ * @return the amount of requests taken
+ */
+int disk_submit_take(disk_rings_t* rings, disk_sqe_t* sqes, disk_producer_t producer);
+
+/**
+ * It stages the completion of the specified process.
+ * It is supposed to be invoked by the device thread.
+ *
+ * @param rings the rings of the device
+ * @param process the process to be unblocked
+ * @param turnaround the time (u.t.) the process
+ *                   is charged for the operation
+ * @param async if is 1 indicates that the process
+ *              has kept running meanwhile
+ */
+void disk_complete(disk_rings_t* rings, process_t* process, int turnaround, int async);
+
+/**
+ * It publishes every staged completion at once.
+ * It is supposed to be invoked by the device thread.
+ *
+ * @param rings the rings of the device
+ */
+void disk_complete_publish(disk_rings_t* rings);
+
+/**
+ * It reaps every published completion, such that each
+ * process is charged for its operation and unblocked,
+ * or, if the operation is asynchronous, such that the
+ * process is signaled. It is supposed to be invoked by
+ * the kernel.
+ *
+ * @param rings the rings of the device
+ *
+ * @return the amount of reaped completions
+ */
+int disk_reap(disk_rings_t* rings);
+
+/**
+ * It detects the process reading tracks sequentially
+ * and, if so, it requests the following tracks to be
+ * read ahead into the buffer cache. The amount of
+ * tracks read ahead doubles while the process keeps
+ * reading sequentially.
+ *
+ * @param process the process which has requested a read
+ * @param volume the volume
+ * @param track the (logical) track being read
+ */
+void disk_read_ahead(process_t* process, struct Volume* volume, int track);
+
+/**
+ * It prints the merging and the coalescing
+ * statistics of the disk scheduler.
  *
- * @param process the process which request the
- *                read/write operation.
  * @param disk_scheduler the disk scheduler
- * @param track the requested track
- * @param read if is 1 indicates that the disk request
- *             is a read operation; otherwise, it indicates
- *             a write operation.
+ * @param fp the file to be printed to
  */
-void disk_request(process_t* process, disk_scheduler_t *disk_scheduler, int track, int read);
+void disk_scheduler_report(disk_scheduler_t* disk_scheduler, FILE* fp);
 
 #endif // OS_PROJECT_DISK_H
@@ -0,0 +1,430 @@
+#include <stdlib.h>
+
+#include "disk_policy.h"
+#include "disk_timing.h"
+
+/* Disk Policy Internal Function Definitions */
+
+/**
+ * It returns the track whose pending request is the
+ * oldest one. If there is no pending request, then
+ * -1 is returned.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param arrival a pointer to receive the arrival
+ *                time of the oldest request
+ */
+static int oldest_track(const disk_scheduler_t* disk_scheduler, long* arrival) {
+    int oldest = -1;
+    int track;
+
+    /* The requests are queued in arrival order in each */
+    /* track, hence only the head of each track is checked */
+    for (track = disk_track_next(disk_scheduler, 0); track >= 0;
+         track = disk_track_next(disk_scheduler, track + 1)) {
+        const disk_request_t* disk_req = (disk_request_t *)disk_scheduler->track_requests[track].head->content;
+
+        if (oldest < 0 || disk_req->arrival < *arrival) {
+            oldest = track;
+            *arrival = disk_req->arrival;
+        }
+    }
+
+    return oldest;
+}
+
+/**
+ * It returns the lowest and the highest tracks having
+ * pending requests, including the specified track.
+ */
+static void pending_bounds(const disk_scheduler_t* disk_scheduler, int track, int* lo, int* hi) {
+    const int first = disk_track_next(disk_scheduler, 0);
+    const int last = disk_track_prev(disk_scheduler, DISK_TRACK_LIMIT);
+
+    *lo = first >= 0 && first < track ? first : track;
+    *hi = last > track ? last : track;
+}
+
+/**
+ * It serves the requests in arrival order.
+ */
+static int fcfs_next_track(disk_scheduler_t* disk_scheduler) {
+    long arrival;
+    const int next = oldest_track(disk_scheduler, &arrival);
+
+    if (next >= 0)
+        disk_scheduler->forward_dir = next >= disk_scheduler->curr_track;
+    return next;
+}
+
+/**
+ * It serves the track closest to the disk arm.
+ */
+static int sstf_next_track(disk_scheduler_t* disk_scheduler) {
+    const int curr = disk_scheduler->curr_track;
+    const int up = disk_track_next(disk_scheduler, curr);
+    const int down = disk_track_prev(disk_scheduler, curr);
+    int next;
+
+    if (up < 0 || down < 0)
+        next = up < 0 ? down : up;
+    else
+        next = up - curr <= curr - down ? up : down;
+
+    if (next >= 0)
+        disk_scheduler->forward_dir = next >= curr;
+    return next;
+}
+
+/**
+ * It sweeps the disk arm from one disk end to the
+ * other one, serving the tracks along the way.
+ */
+static int scan_next_track(disk_scheduler_t* disk_scheduler) {
+    const int curr = disk_scheduler->curr_track;
+    int next;
+
+    if (disk_scheduler->pending_count == 0)
+        return -1;
+
+    if (disk_scheduler->forward_dir) {
+        if ((next = disk_track_next(disk_scheduler, curr)) >= 0)
+            return next;
+        if (curr != DISK_TRACK_LIMIT)
+            return DISK_TRACK_LIMIT;
+
+        disk_scheduler->forward_dir = 0;
+        return disk_track_prev(disk_scheduler, curr);
+    }
+
+    if ((next = disk_track_prev(disk_scheduler, curr)) >= 0)
+        return next;
+    if (curr != 0)
+        return 0;
+
+    disk_scheduler->forward_dir = 1;
+    return disk_track_next(disk_scheduler, curr);
+}
+
+/**
+ * It sweeps the disk arm from the inner track to
+ * the outer one, serving the tracks along the way,
+ * and then it returns to the inner track.
+ */
+static int cscan_next_track(disk_scheduler_t* disk_scheduler) {
+    const int curr = disk_scheduler->curr_track;
+    int next;
+
+    if (disk_scheduler->pending_count == 0)
+        return -1;
+
+    disk_scheduler->forward_dir = 1;
+    if ((next = disk_track_next(disk_scheduler, curr)) >= 0)
+        return next;
+
+    return curr != DISK_TRACK_LIMIT ? DISK_TRACK_LIMIT : 0;
+}
+
+/**
+ * It sweeps the disk arm only as far as the last
+ * track having pending requests in each direction.
+ */
+static int look_next_track(disk_scheduler_t* disk_scheduler) {
+    const int curr = disk_scheduler->curr_track;
+    int next;
+
+    if (disk_scheduler->forward_dir) {
+        if ((next = disk_track_next(disk_scheduler, curr)) < 0
+            && (next = disk_track_prev(disk_scheduler, curr)) >= 0)
+            disk_scheduler->forward_dir = 0;
+    } else {
+        if ((next = disk_track_prev(disk_scheduler, curr)) < 0
+            && (next = disk_track_next(disk_scheduler, curr)) >= 0)
+            disk_scheduler->forward_dir = 1;
+    }
+
+    return next;
+}
+
+/**
+ * It sweeps the disk arm from the inner track to
+ * the outer one only as far as the last track having
+ * pending requests, and then it returns to the first
+ * track having pending requests.
+ */
+static int clook_next_track(disk_scheduler_t* disk_scheduler) {
+    int next;
+
+    disk_scheduler->forward_dir = 1;
+    if ((next = disk_track_next(disk_scheduler, disk_scheduler->curr_track)) >= 0)
+        return next;
+
+    return disk_track_next(disk_scheduler, 0);
+}
+
+/**
+ * It serves the track closest to the disk arm as
+ * the SSTF policy does, unless some request has
+ * waited longer than the deadline, which is served
+ * first, such that no request starves.
+ */
+static int deadline_next_track(disk_scheduler_t* disk_scheduler) {
+    long arrival;
+    const int oldest = oldest_track(disk_scheduler, &arrival);
+
+    if (oldest >= 0 && disk_scheduler->clock - arrival >= DISK_DEADLINE_TIME) {
+        disk_scheduler->forward_dir = oldest >= disk_scheduler->curr_track;
+        return oldest;
+    }
+
+    return sstf_next_track(disk_scheduler);
+}
+
+/**
+ * It estimates the disk arm moving straight
+ * to the specified track.
+ */
+static int direct_seek_estimate(const disk_scheduler_t* disk_scheduler, int track) {
+    return abs(track - disk_scheduler->curr_track);
+}
+
+/**
+ * It estimates the disk arm sweeping up to the
+ * disk end before reversing its direction.
+ */
+static int scan_seek_estimate(const disk_scheduler_t* disk_scheduler, int track) {
+    const int curr = disk_scheduler->curr_track;
+
+    /* It is going from the inner track to the outer one */
+    if (disk_scheduler->forward_dir)
+        return track >= curr ? track - curr : (DISK_TRACK_LIMIT - curr) + (DISK_TRACK_LIMIT - track);
+
+    /* It is going from the outer track to the inner one */
+    return track < curr ? curr - track : curr + track;
+}
+
+/**
+ * It estimates the disk arm sweeping up to the outer
+ * track and returning to the inner one.
+ */
+static int cscan_seek_estimate(const disk_scheduler_t* disk_scheduler, int track) {
+    const int curr = disk_scheduler->curr_track;
+
+    return track >= curr ? track - curr : (DISK_TRACK_LIMIT - curr) + DISK_TRACK_LIMIT + track;
+}
+
+/**
+ * It estimates the disk arm sweeping up to the last
+ * track having pending requests before reversing
+ * its direction.
+ */
+static int look_seek_estimate(const disk_scheduler_t* disk_scheduler, int track) {
+    const int curr = disk_scheduler->curr_track;
+    int lo;
+    int hi;
+
+    pending_bounds(disk_scheduler, curr, &lo, &hi);
+
+    if (disk_scheduler->forward_dir)
+        return track >= curr ? track - curr : (hi - curr) + (hi - track);
+    return track <= curr ? curr - track : (curr - lo) + (track - lo);
+}
+
+/**
+ * It estimates the disk arm sweeping up to the last
+ * track having pending requests and returning to the
+ * first one.
+ */
+static int clook_seek_estimate(const disk_scheduler_t* disk_scheduler, int track) {
+    const int curr = disk_scheduler->curr_track;
+    int lo;
+    int hi;
+
+    pending_bounds(disk_scheduler, curr, &lo, &hi);
+    if (track < lo)
+        lo = track;
+
+    return track >= curr ? track - curr : (hi - curr) + (hi - lo) + (track - lo);
+}
+
+/**
+ * It compares two turnarounds.
+ */
+static int turnaround_cmp(const void* t1, const void* t2) {
+    const long a = *(const long *)t1;
+    const long b = *(const long *)t2;
+
+    return (a > b) - (a < b);
+}
+
+/* Disk Policy Definitions */
+
+const disk_policy_t disk_policies[DISK_POLICY_COUNT] = {
+    [DISK_POLICY_FCFS] = { "FCFS", fcfs_next_track, direct_seek_estimate },
+    [DISK_POLICY_SSTF] = { "SSTF", sstf_next_track, direct_seek_estimate },
+    [DISK_POLICY_SCAN] = { "SCAN", scan_next_track, scan_seek_estimate },
+    [DISK_POLICY_CSCAN] = { "C-SCAN", cscan_next_track, cscan_seek_estimate },
+    [DISK_POLICY_LOOK] = { "LOOK", look_next_track, look_seek_estimate },
+    [DISK_POLICY_CLOOK] = { "C-LOOK", clook_next_track, clook_seek_estimate },
+    [DISK_POLICY_DEADLINE] = { "DEADLINE", deadline_next_track, direct_seek_estimate },
+};
+
+/* Disk Policy Function Definitions */
+
+/**
+ * It returns the lowest track, greater than or equal
+ * to the specified one, having pending requests. If
+ * there is no such track, then -1 is returned.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param from the track from which the search starts
+ */
+int disk_track_next(const disk_scheduler_t* disk_scheduler, int from) {
+    if (from > DISK_TRACK_LIMIT)
+        return -1;
+
+    int w = from / DISK_TRACK_WORD_BITS;
+    unsigned long word = disk_scheduler->pending_tracks[w] & (~0UL << (from % DISK_TRACK_WORD_BITS));
+
+    while (!word) {
+        if (++w == DISK_TRACK_WORDS)
+            return -1;
+        word = disk_scheduler->pending_tracks[w];
+    }
+
+    return w * DISK_TRACK_WORD_BITS + __builtin_ctzl(word);
+}
+
+/**
+ * It returns the highest track, lower than or equal
+ * to the specified one, having pending requests. If
+ * there is no such track, then -1 is returned.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param from the track from which the search starts
+ */
+int disk_track_prev(const disk_scheduler_t* disk_scheduler, int from) {
+    if (from < 0)
+        return -1;
+
+    const int bit = from % DISK_TRACK_WORD_BITS;
+    int w = from / DISK_TRACK_WORD_BITS;
+    unsigned long word = disk_scheduler->pending_tracks[w]
+                         & (bit == DISK_TRACK_WORD_BITS - 1 ? ~0UL : (1UL << (bit + 1)) - 1);
+
+    while (!word) {
+        if (--w < 0)
+            return -1;
+        word = disk_scheduler->pending_tracks[w];
+    }
+
+    return w * DISK_TRACK_WORD_BITS + DISK_TRACK_WORD_BITS - 1 - __builtin_clzl(word);
+}
+
+/**
+ * It replays the specified request stream through
+ * the policy, serving each track in the time needed
+ * to move the arm and to perform the operation.
+ *
+ * @param policy the disk scheduling policy
+ * @param trace the request stream in arrival order
+ * @param size the amount of requests
+ * @param stats a pointer to receive the statistics
+ */
+void disk_policy_replay(const disk_policy_t* policy, const disk_trace_entry_t* trace,
+                        int size, disk_policy_stats_t* stats) {
+    disk_scheduler_t sim = { 0 };
+    disk_request_t* requests = (disk_request_t *)malloc(sizeof(disk_request_t) * (size + 1));
+    long* turnarounds = (long *)malloc(sizeof(long) * (size + 1));
+    list_node_t* node;
+    double total = 0.0;
+    int arrived = 0;
+    int served = 0;
+    int next;
+
+    /* It checks if the replay requests could not be allocated */
+    if (!requests || !turnarounds) {
+        printf("Not enough memory to replay the disk requests.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sim.forward_dir = 1;
+    sim.angular_v = DISk_BASE_ANGULAR_V;
+    stats->seek_distance = 0;
+
+    while (served < size) {
+        /* It queues the requests that have arrived meanwhile */
+        for (; arrived < size && trace[arrived].arrival <= sim.clock; arrived++) {
+            const int track = trace[arrived].track;
+
+            requests[arrived].track = track;
+            requests[arrived].sector = trace[arrived].sector;
+            requests[arrived].arrival = trace[arrived].arrival;
+            list_add(&sim.track_requests[track], &requests[arrived]);
+            sim.pending_tracks[track / DISK_TRACK_WORD_BITS] |= 1UL << (track % DISK_TRACK_WORD_BITS);
+            sim.pending_count++;
+        }
+
+        /* The disk stays idle until the next request arrives */
+        if (sim.pending_count == 0) {
+            sim.clock = trace[arrived].arrival;
+            continue;
+        }
+
+        next = policy->next_track(&sim);
+        stats->seek_distance += abs(next - sim.curr_track);
+        sim.clock += disk_seek_time(abs(next - sim.curr_track));
+        sim.curr_track = next;
+
+        if (list_empty(&sim.track_requests[next]))
+            continue;
+
+        /* Every request for the track is served at once */
+        const disk_request_t* op = (disk_request_t *)sim.track_requests[next].head->content;
+        sim.clock += disk_rotational_latency(sim.angular_v, sim.clock, op->sector)
+                     + disk_transfer_time(sim.angular_v, DISK_REQUEST_SECTORS);
+        while ((node = list_remove_head(&sim.track_requests[next]))) {
+            const disk_request_t* disk_req = (disk_request_t *)node->content;
+
+            turnarounds[served] = sim.clock - disk_req->arrival;
+            total += (double) turnarounds[served++];
+            sim.pending_count--;
+            list_node_free(node);
+        }
+        sim.pending_tracks[next / DISK_TRACK_WORD_BITS] &= ~(1UL << (next % DISK_TRACK_WORD_BITS));
+    }
+
+    qsort(turnarounds, size, sizeof(long), turnaround_cmp);
+    stats->mean_turnaround = size > 0 ? total / size : 0.0;
+    stats->p99_turnaround = size > 0 ? turnarounds[(size * 99 + 99) / 100 - 1] : 0;
+
+    free(requests);
+    free(turnarounds);
+}
+
+/**
+ * It replays the request stream recorded by the
+ * disk scheduler through every policy and prints
+ * their statistics.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param fp the file to be printed to
+ */
+void disk_policy_report(disk_scheduler_t* disk_scheduler, FILE* fp) {
+    disk_policy_stats_t stats;
+    register int i;
+
+    pthread_mutex_lock(&disk_scheduler->mutex);
+
+    fprintf(fp, "Disk policies replayed on %d requests, %ld not recorded (running %s):\n",
+            disk_scheduler->trace_size, disk_scheduler->trace_dropped, disk_scheduler->policy->name);
+    fprintf(fp, "%-10s %14s %14s %14s\n", "Policy", "MeanTurnaround", "P99Turnaround", "SeekDistance");
+
+    for (i = 0; i < DISK_POLICY_COUNT; i++) {
+        disk_policy_replay(&disk_policies[i], disk_scheduler->trace, disk_scheduler->trace_size, &stats);
+        fprintf(fp, "%-10s %14.1lf %14ld %14ld\n", disk_policies[i].name,
+                stats.mean_turnaround, stats.p99_turnaround, stats.seek_distance);
+    }
+
+    pthread_mutex_unlock(&disk_scheduler->mutex);
+}
@@ -0,0 +1,133 @@
+#ifndef OS_PROJECT_DISK_POLICY_H
+#define OS_PROJECT_DISK_POLICY_H
+
+#include <stdio.h>
+
+#include "disk.h"
+
+/**
+ * It represents the policy used by the
+ * disk scheduler when the simulator starts.
+ */
+#define DISK_POLICY (DISK_POLICY_LOOK)
+
+/**
+ * It represents the maximum time (u.t.) a
+ * request may wait under the deadline policy
+ * before it is served ahead of the others.
+ */
+#define DISK_DEADLINE_TIME (100000)
+
+/**
+ * It represents the available disk
+ * scheduling policies.
+ */
+typedef enum DiskPolicyId {
+    DISK_POLICY_FCFS,
+    DISK_POLICY_SSTF,
+    DISK_POLICY_SCAN,
+    DISK_POLICY_CSCAN,
+    DISK_POLICY_LOOK,
+    DISK_POLICY_CLOOK,
+    DISK_POLICY_DEADLINE,
+    DISK_POLICY_COUNT
+} disk_policy_id_t;
+
+/**
+ * It represents a disk scheduling policy. It is
+ * supposed that the disk scheduler mutex is held
+ * while any of its functions is invoked.
+ */
+typedef struct DiskPolicy {
+    /**
+     * It holds the policy name.
+     */
+    const char* name;
+
+    /**
+     * It returns the next track the disk arm must
+     * move to, updating the arm direction if needed.
+     * If there is no pending request, then -1 is
+     * returned.
+     */
+    int (*next_track)(disk_scheduler_t* disk_scheduler);
+
+    /**
+     * It returns the estimated amount of tracks the
+     * disk arm moves until it reaches the specified
+     * track.
+     */
+    int (*seek_estimate)(const disk_scheduler_t* disk_scheduler, int track);
+} disk_policy_t;
+
+/**
+ * It represents the statistics gathered
+ * by replaying a request stream.
+ */
+typedef struct DiskPolicyStats {
+    /**
+     * It holds the mean and the 99-th
+     * percentile turnaround (u.t.).
+     */
+    double mean_turnaround;
+    long p99_turnaround;
+
+    /**
+     * It holds the total amount of
+     * tracks the disk arm has moved.
+     */
+    long seek_distance;
+} disk_policy_stats_t;
+
+/**
+ * The available disk scheduling
+ * policies indexed by their id.
+ */
+extern const disk_policy_t disk_policies[DISK_POLICY_COUNT];
+
+/* Disk Policy Function Prototypes */
+
+/**
+ * It returns the lowest track, greater than or equal
+ * to the specified one, having pending requests. If
+ * there is no such track, then -1 is returned.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param from the track from which the search starts
+ */
+int disk_track_next(const disk_scheduler_t* disk_scheduler, int from);
+
+/**
+ * It returns the highest track, lower than or equal
+ * to the specified one, having pending requests. If
+ * there is no such track, then -1 is returned.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param from the track from which the search starts
+ */
+int disk_track_prev(const disk_scheduler_t* disk_scheduler, int from);
+
+/**
+ * It replays the specified request stream through
+ * the policy, serving each track in the time needed
+ * to move the arm and to perform the operation.
+ *
+ * @param policy the disk scheduling policy
+ * @param trace the request stream in arrival order
+ * @param size the amount of requests
+ * @param stats a pointer to receive the statistics
+ */
+void disk_policy_replay(const disk_policy_t* policy, const disk_trace_entry_t* trace,
+                        int size, disk_policy_stats_t* stats);
+
+/**
+ * It replays the request stream recorded by the
+ * disk scheduler through every policy and prints
+ * their statistics.
+ *
+ * @param disk_scheduler the disk scheduler
+ * @param fp the file to be printed to
+ */
+void disk_policy_report(disk_scheduler_t* disk_scheduler, FILE* fp);
+
+#endif // OS_PROJECT_DISK_POLICY_H
@@ -0,0 +1,74 @@
+#include <math.h>
+
+#include "disk_timing.h"
+
+/* Disk Timing Function Definitions */
+
+/**
+ * It returns the time (u.t.) the arm
+ * takes to move over the specified
+ * amount of tracks.
+ *
+ * @param distance the amount of tracks
+ */
+long disk_seek_time(int distance) {
+    if (distance <= 0)
+        return 0;
+
+    /* It checks if the arm reaches the track while it is still accelerating */
+    if (distance <= DISK_SEEK_COAST_TRACKS)
+        return DISK_SEEK_SETTLE_TIME + (long) (DISK_SEEK_ACCEL_TIME * sqrt(distance));
+
+    return DISK_SEEK_SETTLE_TIME + (long) (DISK_SEEK_ACCEL_TIME * sqrt(DISK_SEEK_COAST_TRACKS))
+           + (long) (distance - DISK_SEEK_COAST_TRACKS) * DISK_SEEK_COAST_TIME;
+}
+
+/**
+ * It returns the time (u.t.) the
+ * platter takes to rotate once.
+ *
+ * @param angular_v the angular velocity (rpm)
+ */
+long disk_rotation_time(int angular_v) {
+    return 60L * 1000000L / angular_v;
+}
+
+/**
+ * It returns the sector the
+ * specified block starts at.
+ *
+ * @param block the disk block
+ */
+int disk_sector(int block) {
+    return block % DISK_SECTORS_PER_TRACK;
+}
+
+/**
+ * It returns the time (u.t.) the platter takes
+ * to rotate until the specified sector is under
+ * the head, supposing the platter has been
+ * spinning since the clock started.
+ *
+ * @param angular_v the angular velocity (rpm)
+ * @param clock the disk clock (u.t.)
+ * @param sector the sector
+ */
+long disk_rotational_latency(int angular_v, long clock, int sector) {
+    const long rotation = disk_rotation_time(angular_v);
+    const long angle = clock % rotation;
+    const long target = sector * rotation / DISK_SECTORS_PER_TRACK;
+
+    return target >= angle ? target - angle : rotation - angle + target;
+}
+
+/**
+ * It returns the time (u.t.) taken to
+ * transfer the specified amount of
+ * sectors from/to the platter.
+ *
+ * @param angular_v the angular velocity (rpm)
+ * @param sectors the amount of sectors
+ */
+long disk_transfer_time(int angular_v, int sectors) {
+    return sectors * disk_rotation_time(angular_v) / DISK_SECTORS_PER_TRACK;
+}
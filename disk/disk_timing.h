@@ -0,0 +1,77 @@
+#ifndef OS_PROJECT_DISK_TIMING_H
+#define OS_PROJECT_DISK_TIMING_H
+
+#include "disk.h"
+
+/**
+ * It represents the amount of sectors of a track
+ * and the amount of sectors a request transfers.
+ */
+#define DISK_SECTORS_PER_TRACK (64)
+#define DISK_REQUEST_SECTORS (8)
+
+/**
+ * It represents the seek curve, supposing a time unit
+ * is a microsecond. A short seek is spent accelerating
+ * and decelerating the arm, hence it grows with the
+ * square root of the distance, whereas a long seek
+ * coasts at full speed once the arm has accelerated
+ * over DISK_SEEK_COAST_TRACKS tracks. Further, every
+ * seek takes DISK_SEEK_SETTLE_TIME for the head to
+ * settle on the track.
+ */
+#define DISK_SEEK_SETTLE_TIME (500)
+#define DISK_SEEK_ACCEL_TIME (400)
+#define DISK_SEEK_COAST_TRACKS (64)
+#define DISK_SEEK_COAST_TIME (40)
+
+/* Disk Timing Function Prototypes */
+
+/**
+ * It returns the time (u.t.) the arm
+ * takes to move over the specified
+ * amount of tracks.
+ *
+ * @param distance the amount of tracks
+ */
+long disk_seek_time(int distance);
+
+/**
+ * It returns the time (u.t.) the
+ * platter takes to rotate once.
+ *
+ * @param angular_v the angular velocity (rpm)
+ */
+long disk_rotation_time(int angular_v);
+
+/**
+ * It returns the sector the
+ * specified block starts at.
+ *
+ * @param block the disk block
+ */
+int disk_sector(int block);
+
+/**
+ * It returns the time (u.t.) the platter takes
+ * to rotate until the specified sector is under
+ * the head, supposing the platter has been
+ * spinning since the clock started.
+ *
+ * @param angular_v the angular velocity (rpm)
+ * @param clock the disk clock (u.t.)
+ * @param sector the sector
+ */
+long disk_rotational_latency(int angular_v, long clock, int sector);
+
+/**
+ * It returns the time (u.t.) taken to
+ * transfer the specified amount of
+ * sectors from/to the platter.
+ *
+ * @param angular_v the angular velocity (rpm)
+ * @param sectors the amount of sectors
+ */
+long disk_transfer_time(int angular_v, int sectors);
+
+#endif // OS_PROJECT_DISK_TIMING_H
@@ -0,0 +1,206 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* O_DIRECT */
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "image.h"
+#include "../tools/math.h"
+
+/* Internal Disk Image Function Prototypes */
+
+/**
+ * It reads/writes the specified bytes at the specified
+ * offset of the backing file. If O_DIRECT is refused by
+ * the host file system, then the page cache is used
+ * from then on.
+ *
+ * @param image the disk image
+ * @param buffer the (aligned) buffer
+ * @param size the amount of bytes
+ * @param offset the file offset
+ * @param read if is 1 indicates a read;
+ *             otherwise, it indicates a write.
+ */
+static void disk_image_transfer(disk_image_t* image, char* buffer, size_t size, off_t offset, int read);
+
+/* Disk Image Function Definitions */
+
+/**
+ * It opens (or creates) the host file backing the
+ * volume and it sizes it to hold every track of
+ * every disk. If DISK_IMAGE is not set, then the
+ * image is left closed.
+ *
+ * @param image the disk image
+ * @param disk_count the amount of disks
+ */
+void disk_image_init(disk_image_t* image, int disk_count) {
+    const off_t size = (off_t) disk_count * (DISK_TRACK_LIMIT + 1) * DISK_IMAGE_TRACK_SIZE;
+    struct stat st;
+    int flags = O_RDWR | O_CREAT;
+
+    image->fd = -1;
+    image->direct = 0;
+    image->disk_count = disk_count;
+    pthread_mutex_init(&image->mutex, NULL);
+    image->read_count = 0;
+    image->write_count = 0;
+    image->read_bytes = 0;
+    image->write_bytes = 0;
+    image->read_ns = 0;
+    image->write_ns = 0;
+
+    if (!DISK_IMAGE)
+        return;
+
+#ifdef O_DIRECT
+    if (DISK_IMAGE_DIRECT)
+        flags |= O_DIRECT;
+#endif // O_DIRECT
+
+    /* The host file system may not support O_DIRECT at all */
+    if ((image->fd = open(DISK_IMAGE_PATH, flags, 0600)) < 0 && flags != (O_RDWR | O_CREAT))
+        image->fd = open(DISK_IMAGE_PATH, O_RDWR | O_CREAT, 0600);
+    else image->direct = flags != (O_RDWR | O_CREAT);
+
+    /* It checks if the image could not be opened. An existing */
+    /* image keeps its contents, whereas a new one stays sparse */
+    if (image->fd < 0 || fstat(image->fd, &st) < 0
+        || (st.st_size < size && ftruncate(image->fd, size) < 0)) {
+        printf("The disk image %s could not be opened.\n", DISK_IMAGE_PATH);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * It reads/writes the specified sectors of a track
+ * from/to the backing file. If the image is closed,
+ * then nothing is done.
+ *
+ * @param image the disk image
+ * @param disk the disk number
+ * @param track the track
+ * @param block the disk block being transferred
+ * @param sector the first sector
+ * @param sectors the amount of sectors
+ * @param read if is 1 indicates that the operation
+ *             is a read; otherwise, it indicates a
+ *             write.
+ */
+void disk_image_io(disk_image_t* image, int disk, int track, int block,
+                   int sector, int sectors, int read) {
+    const off_t region = ((off_t) disk * (DISK_TRACK_LIMIT + 1) + track) * DISK_IMAGE_TRACK_SIZE;
+    const int head = MIN(sectors, DISK_SECTORS_PER_TRACK - sector);
+    struct timespec start;
+    struct timespec end;
+    char* buffer;
+    long elapsed;
+
+    if (image->fd < 0)
+        return;
+
+    /* It checks if the aligned buffer could not be allocated */
+    if (posix_memalign((void **)&buffer, DISK_IMAGE_ALIGNMENT, (size_t) sectors * DISK_SECTOR_SIZE)) {
+        printf("Not enough memory to allocate a disk image buffer.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* A written sector holds its block, such that the */
+    /* image contents may be told apart across runs */
+    if (!read) {
+        memset(buffer, 0, (size_t) sectors * DISK_SECTOR_SIZE);
+        memcpy(buffer, &block, sizeof(int));
+    }
+
+    /* The sectors past the end of the track wrap around to its beginning */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    disk_image_transfer(image, buffer, (size_t) head * DISK_SECTOR_SIZE,
+                        region + (off_t) sector * DISK_SECTOR_SIZE, read);
+    if (head < sectors)
+        disk_image_transfer(image, buffer + (size_t) head * DISK_SECTOR_SIZE,
+                            (size_t) (sectors - head) * DISK_SECTOR_SIZE, region, read);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed = (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+    free(buffer);
+
+    pthread_mutex_lock(&image->mutex);
+    if (read) {
+        image->read_count++;
+        image->read_bytes += (long) sectors * DISK_SECTOR_SIZE;
+        image->read_ns += elapsed;
+    } else {
+        image->write_count++;
+        image->write_bytes += (long) sectors * DISK_SECTOR_SIZE;
+        image->write_ns += elapsed;
+    }
+    pthread_mutex_unlock(&image->mutex);
+}
+
+/**
+ * It prints the host I/O statistics
+ * of the disk image.
+ *
+ * @param image the disk image
+ * @param fp the file to be printed to
+ */
+void disk_image_report(disk_image_t* image, FILE* fp) {
+    if (image->fd < 0)
+        return;
+
+    pthread_mutex_lock(&image->mutex);
+
+    fprintf(fp, "Disk image %s (%s): %ld reads (%ld bytes, mean %.1lf us), "
+                "%ld writes (%ld bytes, mean %.1lf us)\n",
+            DISK_IMAGE_PATH, image->direct ? "O_DIRECT" : "page cache",
+            image->read_count, image->read_bytes,
+            image->read_count > 0 ? image->read_ns / 1000.0 / image->read_count : 0.0,
+            image->write_count, image->write_bytes,
+            image->write_count > 0 ? image->write_ns / 1000.0 / image->write_count : 0.0);
+
+    pthread_mutex_unlock(&image->mutex);
+}
+
+/* Internal Disk Image Function Definitions */
+
+/**
+ * It reads/writes the specified bytes at the specified
+ * offset of the backing file. If O_DIRECT is refused by
+ * the host file system, then the page cache is used
+ * from then on.
+ *
+ * @param image the disk image
+ * @param buffer the (aligned) buffer
+ * @param size the amount of bytes
+ * @param offset the file offset
+ * @param read if is 1 indicates a read;
+ *             otherwise, it indicates a write.
+ */
+static void disk_image_transfer(disk_image_t* image, char* buffer, size_t size, off_t offset, int read) {
+    ssize_t done;
+
+    while (1) {
+        done = read ? pread(image->fd, buffer, size, offset) : pwrite(image->fd, buffer, size, offset);
+        if (done == (ssize_t) size)
+            return;
+
+#ifdef O_DIRECT
+        /* It checks if the transfer is not aligned as O_DIRECT requires */
+        if (done < 0 && errno == EINVAL && image->direct) {
+            fcntl(image->fd, F_SETFL, fcntl(image->fd, F_GETFL) & ~O_DIRECT);
+            image->direct = 0;
+            continue;
+        }
+#endif // O_DIRECT
+
+        printf("The disk image %s could not be %s.\n", DISK_IMAGE_PATH, read ? "read" : "written");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef OS_PROJECT_IMAGE_H
+#define OS_PROJECT_IMAGE_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "disk.h"
+#include "disk_timing.h"
+
+/**
+ * If it is set, then the volume is backed by a
+ * host file, such that every disk operation reads
+ * or writes the sectors it requests. The file is
+ * kept, hence its contents are reused across runs.
+ */
+#define DISK_IMAGE (0)
+#define DISK_IMAGE_PATH "ribabari.img"
+
+/**
+ * If it is set, then the host page cache is bypassed
+ * (O_DIRECT) whenever the host file system allows it.
+ */
+#define DISK_IMAGE_DIRECT (1)
+
+/**
+ * It represents the size (bytes) of a sector,
+ * that of the region each track is mapped to
+ * and the alignment required by O_DIRECT.
+ */
+#define DISK_SECTOR_SIZE (512)
+#define DISK_IMAGE_TRACK_SIZE (DISK_SECTORS_PER_TRACK * DISK_SECTOR_SIZE)
+#define DISK_IMAGE_ALIGNMENT (4096)
+
+/**
+ * It represents the host file backing the volume.
+ */
+typedef struct DiskImage {
+    /**
+     * It holds the file descriptor or
+     * -1 if there is no backing file.
+     */
+    int fd;
+
+    /**
+     * It is set while the file is
+     * accessed with O_DIRECT.
+     */
+    int direct;
+
+    /**
+     * It holds the amount of disks whose
+     * tracks are mapped into the file.
+     */
+    int disk_count;
+
+    /**
+     * It ensures mutual exclusion when
+     * updating the statistics.
+     */
+    pthread_mutex_t mutex;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of reads and writes,
+     * the amount of bytes transferred by them and
+     * the time (ns) they have taken on the host.
+     */
+    long read_count;
+    long write_count;
+    long read_bytes;
+    long write_bytes;
+    long read_ns;
+    long write_ns;
+} disk_image_t;
+
+/* Disk Image Function Prototypes */
+
+/**
+ * It opens (or creates) the host file backing the
+ * volume and it sizes it to hold every track of
+ * every disk. If DISK_IMAGE is not set, then the
+ * image is left closed.
+ *
+ * @param image the disk image
+ * @param disk_count the amount of disks
+ */
+void disk_image_init(disk_image_t* image, int disk_count);
+
+/**
+ * It reads/writes the specified sectors of a track
+ * from/to the backing file. If the image is closed,
+ * then nothing is done.
+ *
+ * @param image the disk image
+ * @param disk the disk number
+ * @param track the track
+ * @param block the disk block being transferred
+ * @param sector the first sector
+ * @param sectors the amount of sectors
+ * @param read if is 1 indicates that the operation
+ *             is a read; otherwise, it indicates a
+ *             write.
+ */
+void disk_image_io(disk_image_t* image, int disk, int track, int block,
+                   int sector, int sectors, int read);
+
+/**
+ * It prints the host I/O statistics
+ * of the disk image.
+ *
+ * @param image the disk image
+ * @param fp the file to be printed to
+ */
+void disk_image_report(disk_image_t* image, FILE* fp);
+
+#endif // OS_PROJECT_IMAGE_H
@@ -0,0 +1,17 @@
+#ifndef OS_PROJECT_IOCLASS_H
+#define OS_PROJECT_IOCLASS_H
+
+/**
+ * It represents the I/O classes, from the highest
+ * priority to the lowest one. The disk serves the
+ * highest class having pending requests, unless a
+ * lower one has waited longer than its bound.
+ */
+typedef enum DiskIoClass {
+    DISK_IOCLASS_RT,
+    DISK_IOCLASS_BE,
+    DISK_IOCLASS_IDLE,
+    DISK_IOCLASS_COUNT
+} disk_ioclass_t;
+
+#endif // OS_PROJECT_IOCLASS_H
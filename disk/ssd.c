@@ -0,0 +1,451 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "disk_timing.h"
+#include "ssd.h"
+
+#ifndef OS_SCHED_KERNEL
+#define OS_SCHED_KERNEL
+#include "../kernel/kernel.h"
+#include "../terminal/terminal.h"
+#endif // OS_SCHED_KERNEL
+
+#define MILLISECONDS_100 (50000000L)
+
+/**
+ * It returns the time (u.t.) a channel
+ * takes to serve the specified request.
+ */
+#define SSD_REQUEST_TIME(disk_req) ((disk_req)->read ? SSD_READ_TIME : SSD_PROGRAM_TIME)
+
+/* Internal SSD Function Prototypes */
+
+/**
+ * It returns the amount of erased blocks of the
+ * specified channel, that is, those blocks that
+ * may become the active one.
+ *
+ * @param ssd the flash device
+ * @param channel the channel
+ */
+static int ssd_free_blocks(const ssd_t* ssd, int channel);
+
+/**
+ * It programs the next page of the active block of
+ * the specified channel. If the active block is full,
+ * then an erased block becomes the active one.
+ *
+ * @param ssd the flash device
+ * @param channel the channel
+ *
+ * @return the programmed page
+ */
+static int ssd_page_program(ssd_t* ssd, int channel);
+
+/**
+ * It reclaims the block of the specified channel
+ * having the least valid pages, such that its valid
+ * pages are relocated into the active block and it
+ * is erased. The time taken is owed by the channel.
+ *
+ * @param ssd the flash device
+ * @param channel the channel
+ *
+ * @return 1 if a block has been reclaimed; otherwise,
+ *         if every block is full of valid pages, then
+ *         0 is returned.
+ */
+static int ssd_gc(ssd_t* ssd, int channel);
+
+/**
+ * It allocates a fresh page for the specified logical
+ * page, from the next channel having room for it, and
+ * it invalidates the page formerly mapped to it.
+ *
+ * @param ssd the flash device
+ * @param page the logical page
+ *
+ * @return the channel of the allocated page
+ */
+static int ssd_page_alloc(ssd_t* ssd, int page);
+
+/**
+ * It queues the submitted request into the channel
+ * serving its logical page. A write is programmed
+ * into a fresh page, hence the garbage collection
+ * may be triggered. It is supposed that the flash
+ * device mutex is held.
+ *
+ * @param ssd the flash device
+ * @param sqe the submitted request
+ */
+static void ssd_enqueue(ssd_t* ssd, const disk_sqe_t* sqe);
+
+/* SSD Function Definitions */
+
+/**
+ * It initializes the flash device.
+ *
+ * @param ssd the flash device
+ */
+void ssd_init(ssd_t* ssd) {
+    register int i;
+
+    for (i = 0; i < SSD_CHANNEL_COUNT; i++)
+        ssd->channels[i] = (ssd_channel_t) { (list_t) { NULL, NULL, 0 }, 0, 0, 0, -1, 0 };
+    for (i = 0; i < SSD_LOGICAL_PAGES; i++)
+        ssd->l2p[i] = -1;
+    for (i = 0; i < SSD_PAGE_COUNT; i++)
+        ssd->p2l[i] = -1;
+    for (i = 0; i < SSD_BLOCK_COUNT; i++) {
+        ssd->valid[i] = 0;
+        ssd->next_page[i] = 0;
+    }
+
+    ssd->next_channel = 0;
+    ssd->pending_count = 0;
+    disk_rings_init(&ssd->rings);
+    pthread_mutex_init(&ssd->mutex, NULL);
+    ssd->clock = 0;
+    ssd->read_count = 0;
+    ssd->write_count = 0;
+    ssd->latency_sum = 0;
+    ssd->gc_count = 0;
+    ssd->relocated_count = 0;
+    ssd->erase_count = 0;
+}
+
+/**
+ * It represents the function that is
+ * going to simulate the flash device,
+ * that serves the pending requests of
+ * every channel on each tick.
+ *
+ * @param ssd the flash device
+ */
+_Noreturn void ssd_run(ssd_t* ssd) {
+    struct timespec start;
+    struct timespec end;
+    list_t served;
+    list_node_t* curr_node;
+    process_t* sync_proc;
+    disk_sqe_t sqes[DISK_RING_BATCH];
+    int count;
+    register int i;
+    register int j;
+
+    clock_gettime(CLOCK_REALTIME, &start);
+    while (1) {
+        /* The submitted requests are queued as soon as they are seen, */
+        /* such that each one is estimated against its channel backlog */
+        for (i = 0; i < DISK_PRODUCER_COUNT; i++)
+            while ((count = disk_submit_take(&ssd->rings, sqes, i)) > 0) {
+                pthread_mutex_lock(&ssd->mutex);
+                for (j = 0; j < count; j++)
+                    ssd_enqueue(ssd, &sqes[j]);
+                pthread_mutex_unlock(&ssd->mutex);
+            }
+
+        clock_gettime(CLOCK_REALTIME, &end);
+        const long elapsed = (end.tv_sec - start.tv_sec) * 1000000000L
+                             + (end.tv_nsec - start.tv_nsec);
+
+        if (elapsed < MILLISECONDS_100)
+            continue;
+
+        start = end;
+        served = (list_t) { NULL, NULL, 0 };
+
+        pthread_mutex_lock(&ssd->mutex);
+        ssd->clock += SSD_TICK_TIME;
+
+        /* Every channel works on its own requests at the same time, */
+        /* paying the time owed to the garbage collection beforehand */
+        for (i = 0; i < SSD_CHANNEL_COUNT; i++) {
+            ssd_channel_t* channel = &ssd->channels[i];
+            const long gc_time = channel->gc_debt < SSD_TICK_TIME ? channel->gc_debt : SSD_TICK_TIME;
+
+            channel->gc_debt -= gc_time;
+            channel->credit += SSD_TICK_TIME - gc_time;
+            channel->busy_time += gc_time;
+
+            while (channel->requests.head != NULL
+                   && SSD_REQUEST_TIME((disk_request_t *)channel->requests.head->content) <= channel->credit) {
+                curr_node = list_remove_head(&channel->requests);
+                disk_request_t* disk_req = (disk_request_t *)curr_node->content;
+
+                channel->credit -= SSD_REQUEST_TIME(disk_req);
+                channel->backlog -= SSD_REQUEST_TIME(disk_req);
+                channel->busy_time += SSD_REQUEST_TIME(disk_req);
+                ssd->latency_sum += ssd->clock - disk_req->arrival;
+                disk_req->turnaround = (int) (ssd->clock - disk_req->arrival);
+
+                /* The request has been served on the tick it has been taken */
+                volume_record(&kernel->volume, disk_req,
+                              ssd->clock - disk_req->arrival - SSD_REQUEST_TIME(disk_req),
+                              SSD_REQUEST_TIME(disk_req));
+                ssd->pending_count--;
+                if (disk_req->read)
+                    ssd->read_count++;
+                else ssd->write_count++;
+
+                list_add(&served, disk_req);
+                list_node_free(curr_node);
+            }
+
+            /* An idle channel does not save time for later */
+            if (channel->requests.head == NULL)
+                channel->credit = 0;
+        }
+
+        pthread_mutex_unlock(&ssd->mutex);
+
+        /* The served requests are completed without holding the mutex */
+        while ((curr_node = list_remove_head(&served))) {
+            disk_request_t* disk_req = (disk_request_t *)curr_node->content;
+
+            /* Each logical page is a region of the backing image */
+            disk_image_io(&kernel->volume.image, 0, disk_req->track, disk_req->block,
+                          disk_req->sector, disk_req->sectors, disk_req->read);
+            /* A journal write leaves the buffer of its track untouched */
+            if (!disk_req->journal)
+                buffer_cache_fill(&kernel->buffer_cache, disk_req->block,
+                                  !disk_req->process && disk_req->read);
+            disk_request_finish(&ssd->rings, disk_req);
+            list_node_free(curr_node);
+        }
+
+        /* It signals the processes whose writes have become durable */
+        while ((sync_proc = (process_t *)buffer_cache_sync_done(&kernel->buffer_cache)))
+            disk_complete(&ssd->rings, sync_proc, 0, 0);
+
+        /* The completions of the whole tick are published at once */
+        disk_complete_publish(&ssd->rings);
+
+        /* It updates the disk log, that shows the flash device load */
+        disk_general_log->pending_requests_size = ssd->pending_count;
+    }
+}
+
+/**
+ * It prints the flash device statistics.
+ *
+ * @param ssd the flash device
+ * @param fp the file to be printed to
+ */
+void ssd_report(ssd_t* ssd, FILE* fp) {
+    long served;
+    register int i;
+
+    pthread_mutex_lock(&ssd->mutex);
+    served = ssd->read_count + ssd->write_count;
+
+    /* The write amplification accounts for the pages the */
+    /* garbage collection has programmed on its own behalf */
+    fprintf(fp, "SSD: %d channels, %ld reads, %ld writes, mean latency %.1lf u.t., "
+                "%ld garbage collections, %ld pages relocated, %ld erases, write amplification %.2lf\n",
+            SSD_CHANNEL_COUNT, ssd->read_count, ssd->write_count,
+            served > 0 ? (double) ssd->latency_sum / served : 0.0,
+            ssd->gc_count, ssd->relocated_count, ssd->erase_count,
+            ssd->write_count > 0 ? (double) (ssd->write_count + ssd->relocated_count) / ssd->write_count : 0.0);
+
+    for (i = 0; i < SSD_CHANNEL_COUNT; i++)
+        fprintf(fp, "Channel %d utilization: %.1lf%%\n", i,
+                ssd->clock > 0 ? 100.0 * ssd->channels[i].busy_time / ssd->clock : 0.0);
+
+    pthread_mutex_unlock(&ssd->mutex);
+}
+
+/* Internal SSD Function Definitions */
+
+/**
+ * It returns the amount of erased blocks of the
+ * specified channel, that is, those blocks that
+ * may become the active one.
+ *
+ * @param ssd the flash device
+ * @param channel the channel
+ */
+static int ssd_free_blocks(const ssd_t* ssd, int channel) {
+    int free_blocks = 0;
+    register int b;
+
+    for (b = channel; b < SSD_BLOCK_COUNT; b += SSD_CHANNEL_COUNT)
+        if (ssd->next_page[b] == 0 && b != ssd->channels[channel].active_block)
+            free_blocks++;
+
+    return free_blocks;
+}
+
+/**
+ * It programs the next page of the active block of
+ * the specified channel. If the active block is full,
+ * then an erased block becomes the active one.
+ *
+ * @param ssd the flash device
+ * @param channel the channel
+ *
+ * @return the programmed page
+ */
+static int ssd_page_program(ssd_t* ssd, int channel) {
+    ssd_channel_t* ch = &ssd->channels[channel];
+    register int b;
+
+    /* It checks if the active block is full, hence an erased one is taken */
+    if (ch->active_block < 0 || ssd->next_page[ch->active_block] == SSD_PAGES_PER_BLOCK) {
+        for (b = channel; b < SSD_BLOCK_COUNT && (ssd->next_page[b] != 0 || b == ch->active_block);
+             b += SSD_CHANNEL_COUNT);
+        ch->active_block = b;
+    }
+
+    return ch->active_block * SSD_PAGES_PER_BLOCK + ssd->next_page[ch->active_block]++;
+}
+
+/**
+ * It reclaims the block of the specified channel
+ * having the least valid pages, such that its valid
+ * pages are relocated into the active block and it
+ * is erased. The time taken is owed by the channel.
+ *
+ * @param ssd the flash device
+ * @param channel the channel
+ *
+ * @return 1 if a block has been reclaimed; otherwise,
+ *         if every block is full of valid pages, then
+ *         0 is returned.
+ */
+static int ssd_gc(ssd_t* ssd, int channel) {
+    ssd_channel_t* ch = &ssd->channels[channel];
+    int victim = -1;
+    int page;
+    int new_page;
+    register int b;
+    register int i;
+
+    /* It chooses the full block having the least valid pages */
+    for (b = channel; b < SSD_BLOCK_COUNT; b += SSD_CHANNEL_COUNT)
+        if (b != ch->active_block && ssd->next_page[b] == SSD_PAGES_PER_BLOCK
+            && (victim < 0 || ssd->valid[b] < ssd->valid[victim]))
+            victim = b;
+
+    if (victim < 0 || ssd->valid[victim] == SSD_PAGES_PER_BLOCK)
+        return 0;
+
+    /* The valid pages are copied out before the block is erased */
+    for (i = 0; i < SSD_PAGES_PER_BLOCK; i++) {
+        page = victim * SSD_PAGES_PER_BLOCK + i;
+        if (ssd->p2l[page] < 0)
+            continue;
+
+        new_page = ssd_page_program(ssd, channel);
+        ssd->p2l[new_page] = ssd->p2l[page];
+        ssd->l2p[ssd->p2l[page]] = new_page;
+        ssd->valid[new_page / SSD_PAGES_PER_BLOCK]++;
+        ssd->p2l[page] = -1;
+
+        ch->gc_debt += SSD_READ_TIME + SSD_PROGRAM_TIME;
+        ssd->relocated_count++;
+    }
+
+    ssd->valid[victim] = 0;
+    ssd->next_page[victim] = 0;
+    ch->gc_debt += SSD_ERASE_TIME;
+    ssd->erase_count++;
+    ssd->gc_count++;
+    return 1;
+}
+
+/**
+ * It allocates a fresh page for the specified logical
+ * page, from the next channel having room for it, and
+ * it invalidates the page formerly mapped to it.
+ *
+ * @param ssd the flash device
+ * @param page the logical page
+ *
+ * @return the channel of the allocated page
+ */
+static int ssd_page_alloc(ssd_t* ssd, int page) {
+    const int old_page = ssd->l2p[page];
+    int channel;
+    int new_page;
+    register int i;
+
+    /* The stale page is reclaimed by a later garbage collection */
+    if (old_page >= 0) {
+        ssd->p2l[old_page] = -1;
+        ssd->valid[old_page / SSD_PAGES_PER_BLOCK]--;
+    }
+
+    /* The writes are spread over the channels, such that they are */
+    /* programmed in parallel. A channel whose active block is full */
+    /* keeps an erased block in reserve for the garbage collection */
+    for (i = 0; i < SSD_CHANNEL_COUNT; i++) {
+        ssd_channel_t* ch;
+
+        channel = (ssd->next_channel + i) % SSD_CHANNEL_COUNT;
+        ch = &ssd->channels[channel];
+
+        if ((ch->active_block >= 0 && ssd->next_page[ch->active_block] < SSD_PAGES_PER_BLOCK)
+            || ssd_free_blocks(ssd, channel) > 1 || ssd_gc(ssd, channel))
+            break;
+    }
+
+    /* It checks if every channel is full of valid pages */
+    if (i == SSD_CHANNEL_COUNT) {
+        printf("The flash device has run out of pages.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    new_page = ssd_page_program(ssd, channel);
+    ssd->p2l[new_page] = page;
+    ssd->l2p[page] = new_page;
+    ssd->valid[new_page / SSD_PAGES_PER_BLOCK]++;
+    ssd->next_channel = (channel + 1) % SSD_CHANNEL_COUNT;
+    return channel;
+}
+
+/**
+ * It queues the submitted request into the channel
+ * serving its logical page. A write is programmed
+ * into a fresh page, hence the garbage collection
+ * may be triggered. It is supposed that the flash
+ * device mutex is held.
+ *
+ * @param ssd the flash device
+ * @param sqe the submitted request
+ */
+static void ssd_enqueue(ssd_t* ssd, const disk_sqe_t* sqe) {
+    disk_request_t* disk_req = create_disk_request();
+    const int page = sqe->track;
+    ssd_channel_t* channel;
+
+    disk_req->process = sqe->process;
+    disk_req->track = page;
+    disk_req->block = sqe->block;
+    disk_req->sector = 0;
+    disk_req->sectors = DISK_REQUEST_SECTORS;
+    disk_req->read = sqe->read;
+    disk_req->async = sqe->async;
+    disk_req->ioclass = sqe->ioclass;
+    disk_req->arrival = ssd->clock;
+    disk_req->merged = NULL;
+    disk_req->fanout = 1;
+    disk_req->copies = sqe->copies;
+    disk_req->journal = sqe->journal;
+
+    /* A read is served by the channel holding the page, whereas */
+    /* a write is programmed out of place into a fresh page */
+    if (!disk_req->read)
+        channel = &ssd->channels[ssd_page_alloc(ssd, page)];
+    else if (ssd->l2p[page] >= 0)
+        channel = &ssd->channels[(ssd->l2p[page] / SSD_PAGES_PER_BLOCK) % SSD_CHANNEL_COUNT];
+    else channel = &ssd->channels[page % SSD_CHANNEL_COUNT];
+
+    /* The request waits for every request queued before it in the channel */
+    channel->backlog += SSD_REQUEST_TIME(disk_req);
+    disk_req->turnaround = 0;
+    list_add(&channel->requests, disk_req);
+    ssd->pending_count++;
+}
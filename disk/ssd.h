@@ -0,0 +1,178 @@
+#ifndef OS_PROJECT_SSD_H
+#define OS_PROJECT_SSD_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "disk.h"
+
+/**
+ * It represents the amount of channels of the
+ * flash device, that serve requests in parallel.
+ */
+#define SSD_CHANNEL_COUNT (4)
+
+/**
+ * It represents the amount of erase blocks of each
+ * channel and the amount of pages of an erase block.
+ * The pages beyond the logical ones (one for each
+ * track) are the over-provisioned space used by the
+ * garbage collection.
+ */
+#define SSD_BLOCKS_PER_CHANNEL (8)
+#define SSD_PAGES_PER_BLOCK (8)
+
+#define SSD_BLOCK_COUNT (SSD_CHANNEL_COUNT * SSD_BLOCKS_PER_CHANNEL)
+#define SSD_PAGE_COUNT (SSD_BLOCK_COUNT * SSD_PAGES_PER_BLOCK)
+#define SSD_LOGICAL_PAGES (DISK_TRACK_LIMIT + 1)
+
+/**
+ * It represents the time (u.t.) taken to read a
+ * page, to program (write) a page and to erase a
+ * block, respectively.
+ */
+#define SSD_READ_TIME (250)
+#define SSD_PROGRAM_TIME (1000)
+#define SSD_ERASE_TIME (10000)
+
+/**
+ * It represents the time (u.t.) each channel
+ * works on every flash device tick. It is as
+ * long as a mean hard disk operation, since a
+ * hard disk performs (at least) one on every
+ * tick.
+ */
+#define SSD_TICK_TIME (DISK_OPERATION_TIME)
+
+/**
+ * It represents a flash channel, that
+ * serves its requests in arrival order.
+ */
+typedef struct SsdChannel {
+    /**
+     * It holds the pending requests.
+     */
+    list_t requests;
+
+    /**
+     * It holds the time (u.t.) left to the
+     * channel in the current tick, the time
+     * owed to the garbage collection and the
+     * time needed to serve the pending requests.
+     */
+    long credit;
+    long gc_debt;
+    long backlog;
+
+    /**
+     * It holds the erase block being
+     * programmed or -1 if there is none.
+     */
+    int active_block;
+
+    /**
+     * It holds the time (u.t.) the
+     * channel has been busy.
+     */
+    long busy_time;
+} ssd_channel_t;
+
+typedef struct Ssd {
+    /**
+     * It holds the channels.
+     */
+    ssd_channel_t channels[SSD_CHANNEL_COUNT];
+
+    /**
+     * It holds the flash translation layer, that is,
+     * the physical page each logical page is mapped
+     * to (or -1) and the logical page each physical
+     * page holds (or -1 if it is free or stale).
+     */
+    int l2p[SSD_LOGICAL_PAGES];
+    int p2l[SSD_PAGE_COUNT];
+
+    /**
+     * It holds the amount of valid pages and
+     * the next page to be programmed of each
+     * erase block (it is 0 if it is erased).
+     */
+    int valid[SSD_BLOCK_COUNT];
+    int next_page[SSD_BLOCK_COUNT];
+
+    /**
+     * It holds the channel the next
+     * page is going to be written to.
+     */
+    int next_channel;
+
+    /**
+     * It holds the rings through which the
+     * requests are submitted and completed.
+     */
+    disk_rings_t rings;
+
+    /**
+     * It holds the amount of pending requests.
+     */
+    int pending_count;
+
+    /**
+     * It ensures mutual exclusion when
+     * handling the flash device.
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     * It holds the flash device clock (u.t.),
+     * that is advanced on every tick.
+     */
+    long clock;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of served reads and
+     * writes and the sum of their latencies.
+     */
+    long read_count;
+    long write_count;
+    long latency_sum;
+
+    /**
+     * It holds the amount of garbage collections,
+     * of pages relocated by them and of erases.
+     */
+    long gc_count;
+    long relocated_count;
+    long erase_count;
+} ssd_t;
+
+/* SSD Function Prototypes */
+
+/**
+ * It initializes the flash device.
+ *
+ * @param ssd the flash device
+ */
+void ssd_init(ssd_t* ssd);
+
+/**
+ * It represents the function that is
+ * going to simulate the flash device,
+ * that serves the pending requests of
+ * every channel on each tick.
+ *
+ * @param ssd the flash device
+ */
+_Noreturn void ssd_run(ssd_t* ssd);
+
+/**
+ * It prints the flash device statistics.
+ *
+ * @param ssd the flash device
+ * @param fp the file to be printed to
+ */
+void ssd_report(ssd_t* ssd, FILE* fp);
+
+#endif // OS_PROJECT_SSD_H
@@ -0,0 +1,463 @@
+#include <stdlib.h>
+
+#include "volume.h"
+#include "disk_policy.h"
+#include "../tools/math.h"
+
+#ifndef OS_SCHED_KERNEL
+#define OS_SCHED_KERNEL
+#include "../kernel/kernel.h"
+#include "../terminal/terminal.h"
+#endif // OS_SCHED_KERNEL
+
+/* Internal Volume Function Prototypes */
+
+/**
+ * It returns the disk whose arm is the nearest
+ * one to the specified track. If some arms are
+ * equally near, then the disk having the least
+ * pending requests is returned.
+ *
+ * @param volume the volume
+ * @param track the requested track
+ */
+static disk_scheduler_t* volume_nearest_disk(volume_t* volume, int track);
+
+/**
+ * It submits the specified request to the device
+ * holding its (logical) track or, if it is a write
+ * to a mirrored volume, to every disk.
+ *
+ * @param volume the volume
+ * @param sqe the request
+ * @param producer the submitting thread
+ */
+static void volume_dispatch(volume_t* volume, disk_sqe_t* sqe, disk_producer_t producer);
+
+/**
+ * It prints the amount of completions reaped
+ * from the rings of a device and how many of
+ * them have been reaped at once on average.
+ *
+ * @param rings the rings of the device
+ * @param device the device name
+ * @param fp the file to be printed to
+ */
+static void volume_rings_report(const disk_rings_t* rings, const char* device, FILE* fp);
+
+/**
+ * It prints the latency histograms of the reads
+ * and of the writes, and the heat map of the
+ * (logical) tracks, such that each character
+ * shows how often a track has been accessed
+ * relative to the hottest one.
+ *
+ * @param volume the volume
+ * @param fp the file to be printed to
+ */
+static void volume_latency_report(volume_t* volume, FILE* fp);
+
+/* Volume Function Definitions */
+
+/**
+ * It initializes the volume, the scheduler
+ * of each disk and the flash device.
+ *
+ * @param volume the volume
+ * @param backend the device backing the volume
+ * @param layout the volume layout
+ */
+void volume_init(volume_t* volume, volume_backend_t backend, volume_layout_t layout) {
+    register int i;
+
+    volume->backend = backend;
+    volume->disk_count = VOLUME_DISK_COUNT;
+    volume->layout = layout;
+    volume->request_count = 0;
+
+    for (i = 0; i < VOLUME_LATENCY_COUNT; i++) {
+        histogram_init(&volume->latency[0][i]);
+        histogram_init(&volume->latency[1][i]);
+    }
+    for (i = 0; i <= DISK_TRACK_LIMIT; i++)
+        volume->heat[i] = 0;
+
+    for (i = 0; i < volume->disk_count; i++)
+        disk_scheduler_init(&volume->disks[i], i);
+    ssd_init(&volume->ssd);
+    disk_image_init(&volume->image, backend == VOLUME_SSD ? 1 : volume->disk_count);
+}
+
+/**
+ * It submits a read/write operation to the volume on
+ * the specified (logical) track. It is translated into
+ * a request to a single disk or, if it is a write to a
+ * mirrored volume, into a request to every disk, such
+ * that it completes once all of them complete. The
+ * request is seen once the producer submits it (see
+ * volume_submit).
+ *
+ * @param process the process which request the
+ *                read/write operation or NULL if it
+ *                is a request of the buffer cache.
+ * @param volume the volume
+ * @param track the requested (logical) track
+ * @param read if is 1 indicates that the request
+ *             is a read operation; otherwise, it indicates
+ *             a write operation.
+ * @param async if is 1 indicates that the process keeps
+ *              running while the operation is performed
+ * @param producer the submitting thread
+ */
+void volume_request(process_t* process, volume_t* volume, int track, int read, int async,
+                    disk_producer_t producer) {
+    disk_sqe_t sqe = { process, track, DISK_BLOCK(track), read, async, DISK_IOCLASS_BE, NULL, 0 };
+
+    if (process) {
+        io_disk_log(process->name, read);
+        sem_post(&io_mutex);
+    }
+
+    __atomic_fetch_add(&volume->request_count, 1, __ATOMIC_RELAXED);
+
+    /* A request of the buffer cache is served in the best-effort */
+    /* class, unless it is a speculative read ahead of a process */
+    if (process)
+        sqe.ioclass = process->ioclass;
+    else if (read)
+        sqe.ioclass = DISK_IOCLASS_IDLE;
+
+    volume_dispatch(volume, &sqe, producer);
+}
+
+/**
+ * It submits a write of the file system journal to
+ * the volume on the specified (logical) track. Unlike
+ * a write-back of the buffer cache, it is neither
+ * merged with the requests to the same track nor does
+ * it clean the buffer of the track, and it is left out
+ * of the track heat map.
+ *
+ * @param volume the volume
+ * @param track the journal (logical) track
+ * @param producer the submitting thread
+ */
+void volume_journal_request(volume_t* volume, int track, disk_producer_t producer) {
+    disk_sqe_t sqe = { NULL, track, DISK_BLOCK(track), 0, 0, DISK_IOCLASS_BE, NULL, 1 };
+
+    __atomic_fetch_add(&volume->request_count, 1, __ATOMIC_RELAXED);
+    volume_dispatch(volume, &sqe, producer);
+}
+
+/**
+ * It publishes every request made by the specified
+ * producer to every device of the volume at once.
+ *
+ * @param volume the volume
+ * @param producer the submitting thread
+ */
+void volume_submit(volume_t* volume, disk_producer_t producer) {
+    register int i;
+
+    if (volume->backend == VOLUME_SSD) {
+        disk_submit_publish(&volume->ssd.rings, producer);
+        return;
+    }
+
+    for (i = 0; i < volume->disk_count; i++)
+        disk_submit_publish(&volume->disks[i].rings, producer);
+}
+
+/**
+ * It reaps the completions posted by every device
+ * of the volume, such that each process is charged
+ * for its operation and unblocked. It is supposed
+ * to be invoked by the kernel.
+ *
+ * @param volume the volume
+ *
+ * @return the amount of reaped completions
+ */
+int volume_reap(volume_t* volume) {
+    int reaped = 0;
+    register int i;
+
+    if (volume->backend == VOLUME_SSD)
+        return disk_reap(&volume->ssd.rings);
+
+    for (i = 0; i < volume->disk_count; i++)
+        reaped += disk_reap(&volume->disks[i].rings);
+
+    return reaped;
+}
+
+/**
+ * It records the latencies of a served request and
+ * the access to its (logical) track. It may be
+ * invoked by several devices at once.
+ *
+ * @param volume the volume
+ * @param disk_req the served request
+ * @param wait the time (u.t.) it has waited in the queue
+ * @param service the time (u.t.) it has been served for
+ */
+void volume_record(volume_t* volume, const disk_request_t* disk_req, long wait, long service) {
+    histogram_t* latency = volume->latency[disk_req->read];
+
+    /* A mirrored write is a single logical request, hence */
+    /* it is only recorded once its last copy is served */
+    if (disk_req->copies && __atomic_sub_fetch(&disk_req->copies[1], 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    /* A request served on the tick it has arrived has not waited */
+    if (wait < 0)
+        wait = 0;
+
+    histogram_record(&latency[VOLUME_LATENCY_WAIT], wait);
+    histogram_record(&latency[VOLUME_LATENCY_SERVICE], service);
+    histogram_record(&latency[VOLUME_LATENCY_TOTAL], wait + service);
+
+    /* The journal writes do not access the file of their track */
+    if (disk_req->journal)
+        return;
+
+    /* The block keeps the logical track, whereas the request */
+    /* holds the track of the disk it has been striped to */
+    __atomic_fetch_add(&volume->heat[INVERSE_DISK_BLOCK(disk_req->block)], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * It returns the (logical) track that has
+ * been accessed the most so far.
+ *
+ * @param volume the volume
+ */
+int volume_hottest_track(volume_t* volume) {
+    int hottest = 0;
+    register int i;
+
+    for (i = 1; i <= DISK_TRACK_LIMIT; i++)
+        if (volume->heat[i] > volume->heat[hottest])
+            hottest = i;
+
+    return hottest;
+}
+
+/**
+ * It returns the (logical) track the arm
+ * of the first disk of the volume is on.
+ *
+ * @param volume the volume
+ */
+int volume_head(volume_t* volume) {
+    const int track = volume->disks[0].curr_track;
+
+    return volume->layout == VOLUME_RAID0 ? track * volume->disk_count : track;
+}
+
+/**
+ * It returns the amount of pending
+ * requests over every disk.
+ *
+ * @param volume the volume
+ */
+int volume_pending_count(volume_t* volume) {
+    int pending_count = volume->ssd.pending_count;
+    register int i;
+
+    for (i = 0; i < volume->disk_count; i++)
+        pending_count += volume->disks[i].pending_count;
+
+    return pending_count;
+}
+
+/**
+ * It prints the throughput of the volume and,
+ * either the share and the scheduler statistics
+ * of each disk, or the flash device statistics,
+ * followed by the latency histograms and the
+ * track heat map.
+ *
+ * @param volume the volume
+ * @param fp the file to be printed to
+ */
+void volume_report(volume_t* volume, FILE* fp) {
+    char device[16];
+    long disk_requests = 0;
+    long elapsed = 0;
+    register int i;
+
+    disk_image_report(&volume->image, fp);
+
+    /* It checks if the volume is backed by the flash device */
+    if (volume->backend == VOLUME_SSD) {
+        elapsed = volume->ssd.clock;
+        fprintf(fp, "Volume: SSD, %ld requests in %ld u.t., throughput %.2lf requests per %d u.t.\n",
+                volume->request_count, elapsed,
+                elapsed > 0 ? (double) volume->request_count * DISK_OPERATION_TIME / elapsed : 0.0,
+                DISK_OPERATION_TIME);
+        ssd_report(&volume->ssd, fp);
+        volume_rings_report(&volume->ssd.rings, "SSD", fp);
+        volume_latency_report(volume, fp);
+        return;
+    }
+
+    for (i = 0; i < volume->disk_count; i++) {
+        disk_requests += volume->disks[i].request_count;
+        elapsed = MAX(elapsed, volume->disks[i].clock);
+    }
+
+    /* Every disk ticks at the same pace, hence the throughput */
+    /* grows with the amount of disks serving requests at once */
+    fprintf(fp, "Volume: %s over %d disk%s, %ld requests (%ld disk requests) in %ld u.t., "
+                "throughput %.2lf requests per %d u.t.\n",
+            volume->disk_count == 1 ? "plain" : volume->layout == VOLUME_RAID0 ? "RAID-0" : "RAID-1",
+            volume->disk_count, volume->disk_count == 1 ? "" : "s",
+            volume->request_count, disk_requests, elapsed,
+            elapsed > 0 ? (double) volume->request_count * DISK_OPERATION_TIME / elapsed : 0.0,
+            DISK_OPERATION_TIME);
+
+    for (i = 0; i < volume->disk_count; i++) {
+        fprintf(fp, "Disk %d share: %.1lf%%\n", i,
+                disk_requests > 0 ? 100.0 * volume->disks[i].request_count / disk_requests : 0.0);
+        disk_scheduler_report(&volume->disks[i], fp);
+        disk_policy_report(&volume->disks[i], fp);
+        snprintf(device, sizeof(device), "Disk %d", i);
+        volume_rings_report(&volume->disks[i].rings, device, fp);
+    }
+
+    volume_latency_report(volume, fp);
+}
+
+/* Internal Volume Function Definitions */
+
+/**
+ * It returns the disk whose arm is the nearest
+ * one to the specified track. If some arms are
+ * equally near, then the disk having the least
+ * pending requests is returned.
+ *
+ * @param volume the volume
+ * @param track the requested track
+ */
+static disk_scheduler_t* volume_nearest_disk(volume_t* volume, int track) {
+    disk_scheduler_t* nearest = NULL;
+    int nearest_distance = 0;
+    int nearest_pending = 0;
+    int distance;
+    int pending;
+    register int i;
+
+    for (i = 0; i < volume->disk_count; i++) {
+        disk_scheduler_t* disk_scheduler = &volume->disks[i];
+
+        pthread_mutex_lock(&disk_scheduler->mutex);
+        distance = abs(disk_scheduler->curr_track - track);
+        pending = disk_scheduler->pending_count;
+        pthread_mutex_unlock(&disk_scheduler->mutex);
+
+        if (!nearest || distance < nearest_distance
+            || (distance == nearest_distance && pending < nearest_pending)) {
+            nearest = disk_scheduler;
+            nearest_distance = distance;
+            nearest_pending = pending;
+        }
+    }
+
+    return nearest;
+}
+
+/**
+ * It prints the amount of completions reaped
+ * from the rings of a device and how many of
+ * them have been reaped at once on average.
+ *
+ * @param rings the rings of the device
+ * @param device the device name
+ * @param fp the file to be printed to
+ */
+static void volume_rings_report(const disk_rings_t* rings, const char* device, FILE* fp) {
+    fprintf(fp, "%s rings: %ld completions reaped by %ld reaps (%.2lf per reap)\n",
+            device, rings->reaped_count, rings->reap_count,
+            rings->reap_count > 0 ? (double) rings->reaped_count / rings->reap_count : 0.0);
+}
+
+/**
+ * It prints the latency histograms of the reads
+ * and of the writes, and the heat map of the
+ * (logical) tracks, such that each character
+ * shows how often a track has been accessed
+ * relative to the hottest one.
+ *
+ * @param volume the volume
+ * @param fp the file to be printed to
+ */
+static void volume_latency_report(volume_t* volume, FILE* fp) {
+    static const char* const names[2][VOLUME_LATENCY_COUNT] = {
+        { "Write wait", "Write service", "Write total" },
+        { "Read wait", "Read service", "Read total" }
+    };
+    static const char shades[] = " .:-=+*#%@";
+    const long hottest = volume->heat[volume_hottest_track(volume)];
+    int read;
+    int track;
+    register int i;
+
+    fprintf(fp, "Volume latencies (u.t.):\n");
+    fprintf(fp, "%-14s %8s %10s %8s %8s %8s %8s %8s\n",
+            "Latency", "Count", "Mean", "P50", "P90", "P99", "P99.9", "Max");
+    for (read = 1; read >= 0; read--)
+        for (i = 0; i < VOLUME_LATENCY_COUNT; i++)
+            histogram_print(&volume->latency[read][i], names[read][i], fp);
+
+    /* An accessed track is never shown as blank */
+    fprintf(fp, "Volume track heat map (hottest track %d, %ld accesses):", volume_hottest_track(volume), hottest);
+    for (track = 0; track <= DISK_TRACK_LIMIT; track++) {
+        if (track % VOLUME_HEAT_MAP_WIDTH == 0)
+            fprintf(fp, "\n%3d-%3d |", track, MIN(track + VOLUME_HEAT_MAP_WIDTH - 1, DISK_TRACK_LIMIT));
+        fputc(volume->heat[track] == 0 ? shades[0]
+              : shades[1 + (volume->heat[track] * (int) (sizeof(shades) - 3)) / hottest], fp);
+    }
+    fputc('\n', fp);
+}
+
+/**
+ * It submits the specified request to the device
+ * holding its (logical) track or, if it is a write
+ * to a mirrored volume, to every disk.
+ *
+ * @param volume the volume
+ * @param sqe the request
+ * @param producer the submitting thread
+ */
+static void volume_dispatch(volume_t* volume, disk_sqe_t* sqe, disk_producer_t producer) {
+    const int track = sqe->track;
+    register int i;
+
+    if (volume->backend == VOLUME_SSD) {
+        /* Each track is a logical page of the flash device */
+        disk_submit(&volume->ssd.rings, producer, sqe);
+    } else if (volume->layout == VOLUME_RAID0) {
+        /* The tracks are striped across the disks, such that */
+        /* the sequential tracks are served by every arm at once */
+        sqe->track = track / volume->disk_count;
+        disk_submit(&volume->disks[track % volume->disk_count].rings, producer, sqe);
+    } else if (sqe->read || volume->disk_count == 1) {
+        /* Any mirror holds the track, hence the nearest arm reads it */
+        disk_submit(&volume_nearest_disk(volume, track)->rings, producer, sqe);
+    } else {
+        sqe->copies = (int *)malloc(sizeof(int) * 2);
+
+        /* It checks if the copies counter could not be allocated */
+        if (!sqe->copies) {
+            printf("Not enough memory to allocate a mirrored write.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* The write is done on every mirror, such that the */
+        /* process is unblocked once the last of them is done */
+        sqe->copies[0] = sqe->copies[1] = volume->disk_count;
+        for (i = 0; i < volume->disk_count; i++)
+            disk_submit(&volume->disks[i].rings, producer, sqe);
+    }
+}
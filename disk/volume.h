@@ -0,0 +1,243 @@
+#ifndef OS_PROJECT_VOLUME_H
+#define OS_PROJECT_VOLUME_H
+
+#include <stdio.h>
+
+#include "disk.h"
+#include "image.h"
+#include "ssd.h"
+#include "../tools/histogram.h"
+
+/**
+ * It represents the amount of disks
+ * the volume is made of. A single disk
+ * is the baseline, whereas raising it
+ * opts into the layout below.
+ */
+#define VOLUME_DISK_COUNT (1)
+
+/**
+ * It represents the layout of the
+ * volume when the simulator starts.
+ */
+#define VOLUME_LAYOUT (VOLUME_RAID0)
+
+/**
+ * It represents the device backing the
+ * volume when the simulator starts.
+ */
+#define VOLUME_BACKEND (VOLUME_HDD)
+
+/**
+ * It represents the amount of tracks
+ * shown in each line of the heat map.
+ */
+#define VOLUME_HEAT_MAP_WIDTH (50)
+
+/**
+ * It represents the available volume layouts.
+ * Under RAID-0 the tracks are striped across
+ * the disks, such that the i-th track lies on
+ * the (i mod N)-th disk. Under RAID-1 every
+ * track is mirrored on every disk, such that a
+ * write goes to all of them and a read goes to
+ * the disk whose arm is the nearest one.
+ */
+typedef enum VolumeLayout {
+    VOLUME_RAID0,
+    VOLUME_RAID1
+} volume_layout_t;
+
+/**
+ * It represents the available devices. The
+ * volume is either made of rotating disks (see
+ * VOLUME_DISK_COUNT and VOLUME_LAYOUT) or of a
+ * single flash device, whose channels already
+ * serve the requests in parallel.
+ */
+typedef enum VolumeBackend {
+    VOLUME_HDD,
+    VOLUME_SSD
+} volume_backend_t;
+
+/**
+ * It represents the latencies measured for each
+ * request, that is, the time (u.t.) it has waited
+ * in the queue, the time the device has taken to
+ * serve it and the sum of both.
+ */
+typedef enum VolumeLatency {
+    VOLUME_LATENCY_WAIT,
+    VOLUME_LATENCY_SERVICE,
+    VOLUME_LATENCY_TOTAL,
+    VOLUME_LATENCY_COUNT
+} volume_latency_t;
+
+typedef struct Volume {
+    /**
+     * It holds the device backing the volume.
+     */
+    volume_backend_t backend;
+
+    /**
+     * It holds the disk schedulers, one
+     * for each disk of the volume, and
+     * the amount of disks.
+     */
+    disk_scheduler_t disks[VOLUME_DISK_COUNT];
+    int disk_count;
+
+    /**
+     * It holds the volume layout.
+     */
+    volume_layout_t layout;
+
+    /**
+     * It holds the flash device, that is
+     * only used by the SSD backend.
+     */
+    ssd_t ssd;
+
+    /**
+     * It holds the host file backing the
+     * volume (see DISK_IMAGE).
+     */
+    disk_image_t image;
+
+    /**
+     * It holds the amount of requests made
+     * to the volume, such that a mirrored
+     * write is counted once.
+     */
+    long request_count;
+
+    /**
+     * It holds the latency histograms of the
+     * writes (0) and of the reads (1), and the
+     * amount of requests served on each
+     * (logical) track.
+     */
+    histogram_t latency[2][VOLUME_LATENCY_COUNT];
+    long heat[DISK_TRACK_LIMIT + 1];
+} volume_t;
+
+/* Volume Function Prototypes */
+
+/**
+ * It initializes the volume, the scheduler
+ * of each disk and the flash device.
+ *
+ * @param volume the volume
+ * @param backend the device backing the volume
+ * @param layout the volume layout
+ */
+void volume_init(volume_t* volume, volume_backend_t backend, volume_layout_t layout);
+
+/**
+ * It submits a read/write operation to the volume on
+ * the specified (logical) track. It is translated into
+ * a request to a single disk or, if it is a write to a
+ * mirrored volume, into a request to every disk, such
+ * that it completes once all of them complete. The
+ * request is seen once the producer submits it (see
+ * volume_submit).
+ *
+ * @param process the process which request the
+ *                read/write operation or NULL if it
+ *                is a request of the buffer cache.
+ * @param volume the volume
+ * @param track the requested (logical) track
+ * @param read if is 1 indicates that the request
+ *             is a read operation; otherwise, it indicates
+ *             a write operation.
+ * @param async if is 1 indicates that the process keeps
+ *              running while the operation is performed
+ * @param producer the submitting thread
+ */
+void volume_request(process_t* process, volume_t* volume, int track, int read, int async,
+                    disk_producer_t producer);
+
+/**
+ * It submits a write of the file system journal to
+ * the volume on the specified (logical) track. Unlike
+ * a write-back of the buffer cache, it is neither
+ * merged with the requests to the same track nor does
+ * it clean the buffer of the track, and it is left out
+ * of the track heat map.
+ *
+ * @param volume the volume
+ * @param track the journal (logical) track
+ * @param producer the submitting thread
+ */
+void volume_journal_request(volume_t* volume, int track, disk_producer_t producer);
+
+/**
+ * It publishes every request made by the specified
+ * producer to every device of the volume at once.
+ *
+ * @param volume the volume
+ * @param producer the submitting thread
+ */
+void volume_submit(volume_t* volume, disk_producer_t producer);
+
+/**
+ * It reaps the completions posted by every device
+ * of the volume, such that each process is charged
+ * for its operation and unblocked. It is supposed
+ * to be invoked by the kernel.
+ *
+ * @param volume the volume
+ *
+ * @return the amount of reaped completions
+ */
+int volume_reap(volume_t* volume);
+
+/**
+ * It records the latencies of a served request and
+ * the access to its (logical) track. It may be
+ * invoked by several devices at once.
+ *
+ * @param volume the volume
+ * @param disk_req the served request
+ * @param wait the time (u.t.) it has waited in the queue
+ * @param service the time (u.t.) it has been served for
+ */
+void volume_record(volume_t* volume, const disk_request_t* disk_req, long wait, long service);
+
+/**
+ * It returns the (logical) track that has
+ * been accessed the most so far.
+ *
+ * @param volume the volume
+ */
+int volume_hottest_track(volume_t* volume);
+
+/**
+ * It returns the (logical) track the arm
+ * of the first disk of the volume is on.
+ *
+ * @param volume the volume
+ */
+int volume_head(volume_t* volume);
+
+/**
+ * It returns the amount of pending
+ * requests over every disk.
+ *
+ * @param volume the volume
+ */
+int volume_pending_count(volume_t* volume);
+
+/**
+ * It prints the throughput of the volume and,
+ * either the share and the scheduler statistics
+ * of each disk, or the flash device statistics,
+ * followed by the latency histograms and the
+ * track heat map.
+ *
+ * @param volume the volume
+ * @param fp the file to be printed to
+ */
+void volume_report(volume_t* volume, FILE* fp);
+
+#endif // OS_PROJECT_VOLUME_H
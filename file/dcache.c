@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dcache.h"
+
+/* Internal Dentry Cache Function Prototypes */
+
+/**
+ * It returns the hash bucket of the specified name in
+ * the specified directory (FNV-1a over both of them).
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ * @return the head link of the hash bucket
+ */
+static dentry_t** dentry_bucket(const dcache_t* dcache, int parent, const char* name);
+
+/**
+ * It returns the entry of the specified name in the
+ * specified directory or NULL if it is not cached.
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ * @return the cached entry or NULL
+ */
+static dentry_t* dentry_find(const dcache_t* dcache, int parent, const char* name);
+
+/**
+ * It unlinks the entry from the LRU list.
+ *
+ * @param dcache the dentry cache
+ * @param dentry the entry
+ */
+static void lru_unlink(dcache_t* dcache, dentry_t* dentry);
+
+/**
+ * It puts the entry as the most recently used one.
+ *
+ * @param dcache the dentry cache
+ * @param dentry the entry
+ */
+static void lru_push(dcache_t* dcache, dentry_t* dentry);
+
+/**
+ * It removes the entry from its hash bucket.
+ *
+ * @param dcache the dentry cache
+ * @param dentry the entry
+ */
+static void hash_remove(dcache_t* dcache, dentry_t* dentry);
+
+/* Dentry Cache Function Definitions */
+
+/**
+ * It initializes the dentry cache.
+ *
+ * @param dcache the dentry cache
+ * @param capacity the maximum amount of names
+ */
+void dcache_init(dcache_t* dcache, int capacity) {
+    dcache->hash_size = 1;
+    while (dcache->hash_size < capacity << 1)
+        dcache->hash_size <<= 1;
+
+    dcache->dentries = (dentry_t *)malloc(sizeof(dentry_t) * capacity);
+    dcache->hash = (dentry_t **)calloc(dcache->hash_size, sizeof(dentry_t *));
+
+    /* It checks if the entries could not be allocated */
+    if (!dcache->dentries || !dcache->hash) {
+        printf("Not enough memory to allocate the dentry cache.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    dcache->capacity = capacity;
+    dcache->size = 0;
+    dcache->lru_head = NULL;
+    dcache->lru_tail = NULL;
+
+    dcache->hit_count = 0;
+    dcache->negative_count = 0;
+    dcache->miss_count = 0;
+    dcache->evict_count = 0;
+}
+
+/**
+ * It looks the specified name up in the specified
+ * directory. If it is cached, then its entry becomes
+ * the most recently used one and it is returned.
+ * Otherwise, NULL is returned.
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ */
+dentry_t* dcache_lookup(dcache_t* dcache, int parent, const char* name) {
+    dentry_t* dentry = dentry_find(dcache, parent, name);
+
+    if (!dentry) {
+        dcache->miss_count++;
+        return NULL;
+    }
+
+    if (dentry->inumber)
+        dcache->hit_count++;
+    else dcache->negative_count++;
+
+    lru_unlink(dcache, dentry);
+    lru_push(dcache, dentry);
+
+    return dentry;
+}
+
+/**
+ * It stores the result of looking the specified name
+ * up in the specified directory, evicting the least
+ * recently used entry if the cache is full.
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ * @param inumber the inode number the name refers
+ *                to or 0 if there is none
+ */
+void dcache_insert(dcache_t* dcache, int parent, const char* name, int inumber) {
+    dentry_t* dentry = dentry_find(dcache, parent, name);
+
+    /* It checks if the name is cached, e.g., a negative */
+    /* entry of a name that has just been created */
+    if (dentry) {
+        dentry->inumber = inumber;
+        lru_unlink(dcache, dentry);
+        lru_push(dcache, dentry);
+        return;
+    }
+
+    if (dcache->size < dcache->capacity)
+        dentry = &dcache->dentries[dcache->size++];
+    else {
+        dentry = dcache->lru_tail;
+        lru_unlink(dcache, dentry);
+        hash_remove(dcache, dentry);
+        dcache->evict_count++;
+    }
+
+    dentry->parent = parent;
+    strncpy(dentry->name, name, FS_NAME_LEN);
+    dentry->name[FS_NAME_LEN - 1] = '\0';
+    dentry->inumber = inumber;
+    dentry->hash_next = *dentry_bucket(dcache, parent, dentry->name);
+    *dentry_bucket(dcache, parent, dentry->name) = dentry;
+    lru_push(dcache, dentry);
+}
+
+/**
+ * It prints the dentry cache statistics.
+ *
+ * @param dcache the dentry cache
+ * @param fp the file to be printed to
+ */
+void dcache_report(dcache_t* dcache, FILE* fp) {
+    const long lookups = dcache->hit_count + dcache->negative_count + dcache->miss_count;
+
+    fprintf(fp, "Dentry cache: %ld hits, %ld negative hits, %ld misses (hit ratio %.1lf%%), "
+                "%ld evictions\n",
+            dcache->hit_count, dcache->negative_count, dcache->miss_count,
+            lookups > 0 ? 100.0 * (lookups - dcache->miss_count) / lookups : 0.0,
+            dcache->evict_count);
+}
+
+/* Internal Dentry Cache Function Definitions */
+
+/**
+ * It returns the hash bucket of the specified name in
+ * the specified directory (FNV-1a over both of them).
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ * @return the head link of the hash bucket
+ */
+static dentry_t** dentry_bucket(const dcache_t* dcache, int parent, const char* name) {
+    unsigned int hash = 2166136261u ^ (unsigned int) parent;
+    const char* c;
+
+    for (c = name; *c; c++)
+        hash = (hash ^ (unsigned char) *c) * 16777619u;
+
+    return &dcache->hash[hash & (dcache->hash_size - 1)];
+}
+
+/**
+ * It returns the entry of the specified name in the
+ * specified directory or NULL if it is not cached.
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ * @return the cached entry or NULL
+ */
+static dentry_t* dentry_find(const dcache_t* dcache, int parent, const char* name) {
+    dentry_t* dentry;
+
+    for (dentry = *dentry_bucket(dcache, parent, name); dentry != NULL; dentry = dentry->hash_next)
+        if (dentry->parent == parent && strcmp(dentry->name, name) == 0)
+            return dentry;
+
+    return NULL;
+}
+
+/**
+ * It unlinks the entry from the LRU list.
+ *
+ * @param dcache the dentry cache
+ * @param dentry the entry
+ */
+static void lru_unlink(dcache_t* dcache, dentry_t* dentry) {
+    if (dentry->prev)
+        dentry->prev->next = dentry->next;
+    else dcache->lru_head = dentry->next;
+
+    if (dentry->next)
+        dentry->next->prev = dentry->prev;
+    else dcache->lru_tail = dentry->prev;
+}
+
+/**
+ * It puts the entry as the most recently used one.
+ *
+ * @param dcache the dentry cache
+ * @param dentry the entry
+ */
+static void lru_push(dcache_t* dcache, dentry_t* dentry) {
+    dentry->prev = NULL;
+    dentry->next = dcache->lru_head;
+
+    if (dcache->lru_head)
+        dcache->lru_head->prev = dentry;
+    else dcache->lru_tail = dentry;
+    dcache->lru_head = dentry;
+}
+
+/**
+ * It removes the entry from its hash bucket.
+ *
+ * @param dcache the dentry cache
+ * @param dentry the entry
+ */
+static void hash_remove(dcache_t* dcache, dentry_t* dentry) {
+    dentry_t** link = dentry_bucket(dcache, dentry->parent, dentry->name);
+
+    while (*link != dentry)
+        link = &(*link)->hash_next;
+    *link = dentry->hash_next;
+}
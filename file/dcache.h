@@ -0,0 +1,139 @@
+#ifndef OS_PROJECT_DCACHE_H
+#define OS_PROJECT_DCACHE_H
+
+#include <stdio.h>
+
+#include "fs_image.h"
+
+/**
+ * It represents the default amount of
+ * names the dentry cache may hold.
+ */
+#define DCACHE_CAPACITY (256)
+
+/**
+ * It represents the amount of time (u.t.)
+ * charged to a process for each name served
+ * from the dentry cache, and for each
+ * directory block read on a miss.
+ */
+#define DCACHE_HIT_TIME (10)
+#define DCACHE_DIR_READ_TIME (DISK_OPERATION_TIME)
+
+/**
+ * It represents a name looked up in a directory.
+ * A negative entry records that the directory has
+ * no entry with that name.
+ */
+typedef struct Dentry {
+    /**
+     * It holds the inode number of the directory
+     * and the name looked up in it.
+     */
+    int parent;
+    char name[FS_NAME_LEN];
+
+    /**
+     * It holds the inode number the name refers
+     * to or 0 if the entry is negative.
+     */
+    int inumber;
+
+    /**
+     * It points to the previous (more recently
+     * used) and to the next (less recently used)
+     * entries in the LRU list.
+     */
+    struct Dentry* prev;
+    struct Dentry* next;
+
+    /**
+     * It points to the next entry
+     * in the same hash bucket.
+     */
+    struct Dentry* hash_next;
+} dentry_t;
+
+typedef struct DentryCache {
+    /**
+     * It holds the entries, the maximum
+     * amount of them and the amount of
+     * them in use.
+     */
+    dentry_t* dentries;
+    int capacity;
+    int size;
+
+    /**
+     * It holds the hash table mapping a
+     * directory and a name to its entry and
+     * the amount of buckets (a power of two).
+     */
+    dentry_t** hash;
+    int hash_size;
+
+    /**
+     * It points to the most recently and
+     * to the least recently used entries.
+     */
+    dentry_t* lru_head;
+    dentry_t* lru_tail;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of lookups served by
+     * a positive and by a negative entry, the
+     * amount of them that went to the directory
+     * and the amount of evicted entries.
+     */
+    long hit_count;
+    long negative_count;
+    long miss_count;
+    long evict_count;
+} dcache_t;
+
+/* Dentry Cache Function Prototypes */
+
+/**
+ * It initializes the dentry cache.
+ *
+ * @param dcache the dentry cache
+ * @param capacity the maximum amount of names
+ */
+void dcache_init(dcache_t* dcache, int capacity);
+
+/**
+ * It looks the specified name up in the specified
+ * directory. If it is cached, then its entry becomes
+ * the most recently used one and it is returned.
+ * Otherwise, NULL is returned.
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ */
+dentry_t* dcache_lookup(dcache_t* dcache, int parent, const char* name);
+
+/**
+ * It stores the result of looking the specified name
+ * up in the specified directory, evicting the least
+ * recently used entry if the cache is full.
+ *
+ * @param dcache the dentry cache
+ * @param parent the inode number of the directory
+ * @param name the name
+ * @param inumber the inode number the name refers
+ *                to or 0 if there is none
+ */
+void dcache_insert(dcache_t* dcache, int parent, const char* name, int inumber);
+
+/**
+ * It prints the dentry cache statistics.
+ *
+ * @param dcache the dentry cache
+ * @param fp the file to be printed to
+ */
+void dcache_report(dcache_t* dcache, FILE* fp);
+
+#endif // OS_PROJECT_DCACHE_H
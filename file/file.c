@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../tools/constants.h"
+#include "../tools/slab.h"
 #include "../terminal/log.h"
+#include "../disk/disk.h"
 
 #include "file.h"
 
@@ -14,6 +17,12 @@
 #define LOG_FS_A(fmt, ...)
 #endif // OS_DEBUG || OS_FS_DEBUG
 
+/**
+ * The slab cache from which the
+ * inodes are allocated.
+ */
+static slab_cache_t inode_cache = SLAB_CACHE_INITIALIZER("inode", inode_t);
+
 /* Inode Function Definitions */
 
 /**
@@ -23,14 +32,15 @@
  * returned.
  *
  * @param the inode id
+ * @param disk the on-disk inode
  *
  * @return a pointer to an inode, however,
  *         if there is not enough memory
  *         to allocate an inode, then NULL
  *         is returned.
  */
-inode_t* inode_create(int id) {
-    inode_t* inode = (inode_t *)malloc(sizeof(inode_t));
+inode_t* inode_create(int id, fs_inode_t* disk) {
+    inode_t* inode = (inode_t *)slab_alloc(&inode_cache);
 
     /* It check if the inode could not be allocated. */
     if (!inode) {
@@ -40,41 +50,11 @@ inode_t* inode_create(int id) {
 
     inode->id = id;
     inode->o_count = 0;
-    inode->mode = F_PERM_OWNER_R | F_PERM_OWNER_W | F_PERM_OWNER_X | F_PERM_OTHER_R | F_PERM_OTHER_W;
-    inode->last_accessed = -1;
-    inode->last_modified = -1;
-    inode->size = (100 * (1 + (rand() % 10))) + (rand() % RAND_MAX);
+    inode->disk = disk;
 
     return inode;
 }
 
-/* Ilist Function Prototypes */
-
-/**
- * It returns a pointer to an ilist.
- * If there is not enough memory to
- * allocate an ilist, then the
- * application is exited.
- *
- * @return a pointer to an ilist, however,
- *         if there is not enough memory
- *         to allocate an ilist, then the
- *         application is exited.
- */
-ilist_t* ilist_create() {
-    ilist_t* ilist = (ilist_t *)malloc(sizeof(ilist_t));
-
-    /* It checks if the ilist could not be allocated. */
-    if (!ilist) {
-        printf("Not enough memory to allocate an ilist.\n");
-        exit(EXIT_FAILURE);
-    }
-
-    ilist->inode_list = list_init();
-
-    return ilist;
-}
-
 /* File Table Function Definitions */
 
 /**
@@ -83,7 +63,9 @@ ilist_t* ilist_create() {
  * @param file_table a pointer to a file table
  */
 void file_table_init(file_table_t* file_table) {
-    file_table->ilist = ilist_create();
+    itable_init(&file_table->itable);
+    fs_image_mount(&file_table->image);
+    dcache_init(&file_table->dcache, DCACHE_CAPACITY);
 }
 
 /**
@@ -101,12 +83,74 @@ void file_table_init(file_table_t* file_table) {
  *         NULL is returned.
  */
 inode_t* find_inode(file_table_t* file_table, int inumber) {
-    FOREACH(file_table->ilist->inode_list, inode_t*) {
-        if (it->id == inumber)
-            return it;
-    }
+    return itable_find(&file_table->itable, inumber);
+}
 
-    return NULL;
+/**
+ * It resolves the specified path, from the root
+ * directory, into an inode number. If create is
+ * set, then the missing directories along the path
+ * and the file itself are created. The time (u.t.)
+ * taken by the lookups is added to the cost.
+ *
+ * @param file_table the file table
+ * @param path the path
+ * @param create if it is 1, then the missing
+ *               names are created
+ * @param cost a pointer to receive the time
+ *
+ * @return the inode number or 0 if the path
+ *         could not be resolved.
+ */
+int fs_lookup(file_table_t* file_table, const char* path, int create, long* cost) {
+    int inumber = FS_ROOT_INUMBER;
+    const char* name = path;
+    char component[FS_NAME_LEN];
+    size_t len;
+
+    while (1) {
+        fs_inode_t* dir = fs_image_inode_find(&file_table->image, inumber);
+        dentry_t* dentry;
+        int reads;
+
+        /* It skips the separators and it takes the following name */
+        name += strspn(name, "/");
+        if (!*name)
+            return inumber;
+
+        len = strcspn(name, "/");
+        if (len >= FS_NAME_LEN || !dir || dir->type != FS_DIRECTORY)
+            return 0;
+
+        memcpy(component, name, len);
+        component[len] = '\0';
+        name += len;
+
+        /* A cached name is resolved without reading the directory */
+        if ((dentry = dcache_lookup(&file_table->dcache, dir->id, component))) {
+            *cost += DCACHE_HIT_TIME;
+            inumber = dentry->inumber;
+        } else {
+            inumber = fs_image_dir_lookup(&file_table->image, dir, component, &reads);
+            *cost += (long) reads * DCACHE_DIR_READ_TIME;
+            dcache_insert(&file_table->dcache, dir->id, component, inumber);
+        }
+
+        /* It checks if the name is missing, hence it is created if requested */
+        if (!inumber) {
+            fs_inode_t* inode;
+
+            if (!create)
+                return 0;
+
+            name += strspn(name, "/");
+            if (!(inode = fs_image_create(&file_table->image, dir, component, *name ? FS_DIRECTORY : FS_REGULAR)))
+                return 0;
+
+            inumber = inode->id;
+            dcache_insert(&file_table->dcache, dir->id, component, inumber);
+        }
+    }
 }
 
 /* File Request Function Prototypes */
@@ -127,20 +171,23 @@ void fs_read_request(file_table_t* file_table, process_t* process, int block) {
 
     inode_t* inode = find_inode(file_table, inumber);
 
+    /* The allocation of the file inode is journaled */
+    fs_journal_begin(&file_table->image, FS_JOURNAL_INODE_CREDITS);
+
     /* It checks if there is no active inode in the file table with that inumber */
     if (!inode) {
         /* A open request is made, an inode for the file is returned */
         inode = fs_open_request(file_table, process->name, inumber);
 
         /* Update the inode last modified field */
-        time(&inode->last_modified);
+        time(&inode->disk->last_modified);
 
         LOG_FS_A("An inode %d has been put as an active file by process %s (%d) from a read operation.\n", inumber, process->name, process->id);
     }
 
     /* It checks if the process has not before opened this file */
     if (!has_opened_file(process, inumber)) {
-        list_add(process->o_files, inumber);
+        fd_table_open(&process->o_files, inumber);
 
         /* Increase the counter of the amount of process */
         /* has this file opened */
@@ -150,7 +197,8 @@ void fs_read_request(file_table_t* file_table, process_t* process, int block) {
     }
 
     /* Update the inode last accessed field */
-    time(&inode->last_accessed);
+    time(&inode->disk->last_accessed);
+    fs_journal_end(&file_table->image);
 
     LOG_FS_A("Process %s is reading from the inode %d.\n", process->name, inumber);
 }
@@ -171,19 +219,22 @@ void fs_write_request(file_table_t* file_table, process_t* process, int block) {
 
     inode_t* inode = find_inode(file_table, inumber);
 
+    /* The updates of the file metadata are journaled */
+    fs_journal_begin(&file_table->image, FS_JOURNAL_INODE_CREDITS + FS_JOURNAL_GROW_CREDITS);
+
     /* It checks if the inode could not be found in the file table */
     if (!inode) {
         /* A open request is made, an inode for the file is returned */
         inode = fs_open_request(file_table, process->name, inumber);
 
-        time(&inode->last_accessed);
+        time(&inode->disk->last_accessed);
 
         LOG_FS_A("An inode %d has been put as an active file by process %s (%d) from a write operation.\n", inumber, process->name, process->id);
     }
 
     /* It checks if the process has not before opened this file */
     if (!has_opened_file(process, inumber)) {
-        list_add(process->o_files, inumber);
+        fd_table_open(&process->o_files, inumber);
 
         /* Increase the counter of the amount of process */
         /* has this file opened */
@@ -192,8 +243,11 @@ void fs_write_request(file_table_t* file_table, process_t* process, int block) {
         LOG_FS_A("Process %s is in its first time being activating the inode %d from a write operation.\n", process->name, inumber);
     }
 
-    /* Update both access time fields */
-    time(&inode->last_modified);
+    /* Store the written block and update the modification time */
+    fs_image_write(&file_table->image, inode->disk);
+    fs_journal_dirty(&file_table->image, inode->disk);
+    time(&inode->disk->last_modified);
+    fs_journal_end(&file_table->image);
 
     LOG_FS_A("Process %s is writing at the inode %d.\n", process->name, inumber);
 }
@@ -206,10 +260,10 @@ void fs_write_request(file_table_t* file_table, process_t* process, int block) {
  * @param inumber the inode's number
  */
 inode_t *fs_open_request(file_table_t *file_table, const char *owner, int inumber) {
-    inode_t *inode = inode_create(inumber);
+    inode_t *inode = inode_create(inumber, fs_image_inode(&file_table->image, inumber));
 
-    /* Add the inode into the active inode list */
-    list_add(file_table->ilist->inode_list, inode);
+    /* Add the inode into the active inode table */
+    itable_insert(&file_table->itable, inode);
 
     io_fs_log(owner, inumber, IO_LOG_FS_F_OPEN);
     sem_post(&io_mutex);
@@ -226,22 +280,110 @@ inode_t *fs_open_request(file_table_t *file_table, const char *owner, int inumbe
  * @param inumber the inode's number
  */
 void fs_close_request(file_table_t* file_table, process_t* process, int inumber) {
-    FOREACH(file_table->ilist->inode_list, inode_t*) {
-        if (it->id == inumber) {
-            it->o_count--;
-
-            /* It checks if that process that has been just finished */
-            /* it was the last process using this file, then the file */
-            /* will be closed. */
-            if (it->o_count == 0) {
-                /* Remove the current inode from the open file table */
-                list_remove_node(file_table->ilist->inode_list, curr_node);
-
-                io_fs_log(process->name, inumber, IO_LOG_FS_F_CLOSE);
-                sem_post(&io_mutex);
-            }
-
-            break;
-        }
+    inode_t* inode = find_inode(file_table, inumber);
+
+    if (!inode)
+        return;
+
+    /* It checks if that process that has been just finished */
+    /* it was the last process using this file, then the file */
+    /* will be closed. */
+    if (--inode->o_count == 0) {
+        /* Its delayed blocks are allocated once it is no longer written */
+        fs_journal_begin(&file_table->image, FS_JOURNAL_GROW_CREDITS);
+        fs_image_flush(&file_table->image, inode->disk);
+        fs_journal_end(&file_table->image);
+
+        /* Remove the inode from the open file table */
+        itable_remove(&file_table->itable, inumber);
+        slab_free(&inode_cache, inode);
+
+        io_fs_log(process->name, inumber, IO_LOG_FS_F_CLOSE);
+        sem_post(&io_mutex);
+    }
+}
+
+/**
+ * It opens the file at the specified path and it
+ * returns the descriptor the process refers to it
+ * by. The time taken by the path lookup is charged
+ * to the process.
+ *
+ * @param file_table the file table
+ * @param process the process which has requested
+ *                the open operation
+ * @param path the path
+ * @param create if it is 1, then the file (and
+ *               its directories) is created if
+ *               it does not exist
+ *
+ * @return the descriptor or -1 if the path
+ *         could not be resolved.
+ */
+int fs_open_path_request(file_table_t* file_table, process_t* process, const char* path, int create) {
+    const char* name = path;
+    long cost = 0;
+    int credits = 0;
+    inode_t* inode;
+    int inumber;
+    int fd;
+
+    /* The names created along the path are journaled, hence */
+    /* the operation is refused if a transaction may not hold */
+    /* every name of the path */
+    while (create && *(name += strspn(name, "/"))) {
+        credits += FS_JOURNAL_CREATE_CREDITS;
+        name += strcspn(name, "/");
+    }
+
+    if (!fs_journal_begin(&file_table->image, credits)) {
+        LOG_FS_A("Process %s could not create the path %s, whose names do not fit in a transaction.\n", process->name, path);
+        return -1;
+    }
+
+    inumber = fs_lookup(file_table, path, create, &cost);
+    fs_journal_end(&file_table->image);
+
+    process->remaining -= cost;
+
+    if (!inumber) {
+        LOG_FS_A("Process %s could not resolve the path %s.\n", process->name, path);
+        return -1;
     }
-}
\ No newline at end of file
+
+    /* It checks if the process has opened this file before */
+    if ((fd = fd_table_find(&process->o_files, inumber)) != -1)
+        return fd;
+
+    if (!(inode = find_inode(file_table, inumber)))
+        inode = fs_open_request(file_table, process->name, inumber);
+
+    fd = fd_table_open(&process->o_files, inumber);
+    inode->o_count++;
+    time(&inode->disk->last_accessed);
+
+    LOG_FS_A("Process %s has opened %s (inode %d) as the descriptor %d.\n", process->name, path, inumber, fd);
+    return fd;
+}
+
+/**
+ * It closes the specified descriptor of
+ * the process, and the file it refers to
+ * if it was its last user.
+ *
+ * @param file_table the file table
+ * @param process the process which has requested
+ *                the close operation
+ * @param fd the descriptor
+ */
+void fs_close_fd_request(file_table_t* file_table, process_t* process, int fd) {
+    const int inumber = fd_table_close(&process->o_files, fd);
+
+    /* It checks if the descriptor was not open */
+    if (inumber == -1) {
+        LOG_FS_A("Process %s has closed the descriptor %d, which was not open.\n", process->name, fd);
+        return;
+    }
+
+    fs_close_request(file_table, process, inumber);
+}
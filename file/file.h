@@ -27,6 +27,9 @@
 
 #include "../tools/list.h"
 #include "../process/process.h"
+#include "inode_table.h"
+#include "fs_image.h"
+#include "dcache.h"
 
 /* File Description Definitions */
 
@@ -59,7 +62,7 @@ typedef enum FilePermission {
     F_PERM_OTHER_X = (1 << 0),
 } file_perm_t;
 
-typedef struct {
+typedef struct Inode {
     /**
      * It represents the inode id.
      */
@@ -73,45 +76,33 @@ typedef struct {
     int o_count;
 
     /**
-     * It contains the file mode that specifies
-     * the file's access control for the file's
-     * owner, owner's group and others.
+     * It points to the on-disk inode, that is,
+     * the file mode, its size, its access times
+     * and its data blocks (see fs_inode_t).
      */
-    short mode;
+    fs_inode_t* disk;
+} inode_t;
 
-    /**
-     * It contains the time when this
-     * file has been last accessed.
-     */
-    time_t last_accessed;
+/* File Table Structure Definitions */
 
+typedef struct FileTable {
     /**
-     * It contains the time when this
-     * file has been last modified.
+     * It stores the current active open
+     * files indexed by their inode number.
      */
-    time_t last_modified;
+    itable_t itable;
 
     /**
-     * It holds the file size measured
-     * in bytes.
+     * It holds the file system image
+     * the inodes are stored on.
      */
-    long size;
-} inode_t;
+    fs_image_t image;
 
-typedef struct FileDescriptorList {
     /**
-     * An inode list.
+     * It caches the names looked up in
+     * the directories of the image.
      */
-    list_t* inode_list;
-} ilist_t;
-
-/* File Table Structure Definitions */
-
-typedef struct FileTable {
-    /**
-     * It stores the current active open files.
-     */
-    ilist_t* ilist;
+    dcache_t dcache;
 
     /**
      * It holds the next inode id.
@@ -151,28 +142,14 @@ typedef struct FileSystemOperationRequest {
  * returned.
  *
  * @param the inode id
+ * @param disk the on-disk inode
  *
  * @return a pointer to an inode, however,
  *         if there is not enough memory
  *         to allocate an inode, then NULL
  *         is returned.
  */
-inode_t* inode_create(int id);
-
-/* Ilist Function Prototypes */
-
-/**
- * It returns a pointer to an ilist.
- * If there is not enough memory to
- * allocate an ilist, then the
- * application is exited.
- *
- * @return a pointer to an ilist, however,
- *         if there is not enough memory
- *         to allocate an ilist, then the
- *         application is exited.
- */
-ilist_t* ilist_create();
+inode_t* inode_create(int id, fs_inode_t* disk);
 
 /* File Table Function Prototypes */
 
@@ -199,6 +176,24 @@ void file_table_init(file_table_t* file_table);
  */
 inode_t* find_inode(file_table_t* file_table, int inumber);
 
+/**
+ * It resolves the specified path, from the root
+ * directory, into an inode number. If create is
+ * set, then the missing directories along the path
+ * and the file itself are created. The time (u.t.)
+ * taken by the lookups is added to the cost.
+ *
+ * @param file_table the file table
+ * @param path the path
+ * @param create if it is 1, then the missing
+ *               names are created
+ * @param cost a pointer to receive the time
+ *
+ * @return the inode number or 0 if the path
+ *         could not be resolved.
+ */
+int fs_lookup(file_table_t* file_table, const char* path, int create, long* cost);
+
 /* File Request Function Prototypes */
 
 /**
@@ -247,4 +242,35 @@ inode_t *fs_open_request(file_table_t *file_table, const char *owner, int inumbe
   */
 void fs_close_request(file_table_t* file_table, process_t* process, int inumber);
 
+/**
+ * It opens the file at the specified path and it
+ * returns the descriptor the process refers to it
+ * by. The time taken by the path lookup is charged
+ * to the process.
+ *
+ * @param file_table the file table
+ * @param process the process which has requested
+ *                the open operation
+ * @param path the path
+ * @param create if it is 1, then the file (and
+ *               its directories) is created if
+ *               it does not exist
+ *
+ * @return the descriptor or -1 if the path
+ *         could not be resolved.
+ */
+int fs_open_path_request(file_table_t* file_table, process_t* process, const char* path, int create);
+
+/**
+ * It closes the specified descriptor of
+ * the process, and the file it refers to
+ * if it was its last user.
+ *
+ * @param file_table the file table
+ * @param process the process which has requested
+ *                the close operation
+ * @param fd the descriptor
+ */
+void fs_close_fd_request(file_table_t* file_table, process_t* process, int fd);
+
 #endif // OS_PROJECT_FILE_H
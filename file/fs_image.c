@@ -0,0 +1,912 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../disk/disk.h"
+#include "file.h"
+#include "fs_image.h"
+
+_Static_assert(sizeof(fs_superblock_t) <= FS_BLOCK_SIZE, "The superblock must fit in a block");
+_Static_assert(sizeof(fs_inode_t) <= FS_INODE_SIZE, "An inode must fit in its table entry");
+_Static_assert(FS_INODE_COUNT > FS_ROOT_INDEX, "There must be an inode for each track and the root");
+_Static_assert(sizeof(fs_extent_leaf_t) <= FS_BLOCK_SIZE, "An extent leaf must fit in a block");
+_Static_assert(FS_INODE_EXTENTS * FS_LEAF_EXTENTS >= FS_FILE_BLOCKS, "The extent tree must map a whole file");
+_Static_assert(FS_LEAF_EXTENTS >= FS_FILE_BLOCKS, "A file must need a single extent leaf at most");
+_Static_assert(FS_INODE_COUNT <= FS_BLOCK_SIZE * 8 && FS_DATA_BLOCK_COUNT <= FS_BLOCK_SIZE * 8,
+               "Each bitmap must fit in a block, as the journal credits count");
+
+/**
+ * It tests and sets the bit of the
+ * specified entry in a bitmap.
+ */
+#define FS_BIT_TEST(bitmap, i) ((bitmap)[(i) >> 3] & (1 << ((i) & 7)))
+#define FS_BIT_SET(bitmap, i) ((bitmap)[(i) >> 3] |= (1 << ((i) & 7)))
+#define FS_BIT_CLEAR(bitmap, i) ((bitmap)[(i) >> 3] &= ~(1 << ((i) & 7)))
+
+/**
+ * It returns the amount of leaves of the extent
+ * tree of an inode, that is, the inode itself or
+ * the leaf blocks of its index entries.
+ */
+#define FS_EXTENT_LEAVES(inode) ((inode)->depth ? (inode)->extent_count : 1)
+
+/**
+ * It represents the fragmentation of a file, that
+ * is, its extents and the distance (blocks) sought
+ * between them when it is read sequentially.
+ */
+typedef struct {
+    int inumber;
+    int type;
+    int blocks;
+    int extents;
+    long distance;
+} fs_file_frag_t;
+
+/* Internal File System Image Function Prototypes */
+
+/**
+ * It returns the specified entry of the
+ * inode table, straight from the mapping.
+ *
+ * @param image the file system image
+ * @param index the inode table entry
+ */
+static fs_inode_t* fs_image_inode_at(fs_image_t* image, int index);
+
+/**
+ * It allocates the specified entry of the inode
+ * table as an empty inode of the specified type.
+ *
+ * @param image the file system image
+ * @param index the inode table entry
+ * @param type the inode type
+ */
+static fs_inode_t* fs_image_inode_alloc(fs_image_t* image, int index, fs_inode_type_t type);
+
+/**
+ * It writes an empty file system onto the image,
+ * that is, the superblock and both bitmaps cleared.
+ *
+ * @param image the file system image
+ */
+static void fs_image_format(fs_image_t* image);
+
+/**
+ * It allocates a run of up to count free data blocks
+ * and it returns its first block within the image, its
+ * length being stored in length. The run starts at the
+ * goal if it is free; otherwise, the first run as long
+ * as requested past it is taken, or the longest one if
+ * there is none. The blocks reserved by the delayed
+ * writes are left free, hence if no other block is
+ * free, then -1 is returned. The bitmap bytes it sets
+ * lie on a single block (see FS_JOURNAL_SHARED_CREDITS).
+ *
+ * @param image the file system image
+ * @param goal the data block the search starts at,
+ *             or -1 to start past the last run
+ * @param count the amount of blocks requested
+ * @param length a pointer to receive the length
+ */
+static int fs_image_extent_alloc(fs_image_t* image, int goal, int count, int* length);
+
+/**
+ * It frees the specified run of data blocks.
+ *
+ * @param image the file system image
+ * @param start the first block within the image
+ * @param length the amount of blocks
+ */
+static void fs_image_extent_free(fs_image_t* image, int start, int length);
+
+/**
+ * It returns the extents of the specified leaf of
+ * the extent tree of a file, and it stores their
+ * amount in count.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param leaf the leaf (see FS_EXTENT_LEAVES)
+ * @param count a pointer to receive the amount
+ */
+static fs_extent_t* fs_image_extent_leaf(fs_image_t* image, const fs_inode_t* inode, int leaf, int* count);
+
+/**
+ * It maps the specified run of data blocks past the
+ * end of a file, merging it with the last extent if
+ * they are contiguous. A leaf block is allocated if
+ * the tree is full. If it could not be, then 0 is
+ * returned; otherwise, 1 is returned.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param start the first block within the image
+ * @param length the amount of blocks
+ */
+static int fs_image_extent_append(fs_image_t* image, fs_inode_t* inode, int start, int length);
+
+/**
+ * It allocates and maps the specified amount of blocks
+ * past the end of a file, in as few runs as possible,
+ * starting right past its last extent. The blocks of
+ * a regular file are written to the image as well. It
+ * returns the amount of blocks mapped.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param count the amount of blocks
+ */
+static int fs_image_grow(fs_image_t* image, fs_inode_t* inode, int count);
+
+/**
+ * It compares the fragmentation of two files by
+ * their extents and their distance, in descending
+ * order.
+ */
+static int fs_file_frag_cmp(const void* f1, const void* f2);
+
+/* File System Image Function Definitions */
+
+/**
+ * It maps the file system image into memory, and it
+ * formats it if it does not hold a file system yet.
+ * The mapping is private, such that the metadata only
+ * reaches the host file through the journal. If the
+ * image could not be mapped, then the application is
+ * exited.
+ *
+ * @param image the file system image
+ */
+void fs_image_mount(fs_image_t* image) {
+    const size_t size = (size_t) FS_BLOCK_COUNT * FS_BLOCK_SIZE;
+    fs_superblock_t superblock;
+    struct stat st;
+
+    image->fd = -1;
+    image->base = MAP_FAILED;
+
+    if (FS_IMAGE) {
+        /* An existing image keeps its contents, whereas a new one stays sparse */
+        if ((image->fd = open(FS_IMAGE_PATH, O_RDWR | O_CREAT, 0600)) >= 0 && fstat(image->fd, &st) == 0
+            && ((size_t) st.st_size >= size || ftruncate(image->fd, size) == 0)) {
+            /* An image that has not been unmounted cleanly gets */
+            /* its last transaction replayed before it is mapped */
+            fs_journal_init(image, pread(image->fd, &superblock, sizeof(superblock), 0) != sizeof(superblock)
+                                   || superblock.magic != FS_MAGIC || superblock.version != FS_VERSION
+                                   || superblock.clean);
+            image->base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, image->fd, 0);
+        }
+    } else {
+        fs_journal_init(image, 1);
+        image->base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    /* It checks if the image could not be mapped */
+    if (image->base == MAP_FAILED) {
+        printf("The file system image %s could not be mapped.\n", FS_IMAGE_PATH);
+        exit(EXIT_FAILURE);
+    }
+
+    image->superblock = (fs_superblock_t *)(image->base + FS_SUPERBLOCK * FS_BLOCK_SIZE);
+    image->inode_bitmap = (unsigned char *)(image->base + FS_INODE_BITMAP * FS_BLOCK_SIZE);
+    image->block_bitmap = (unsigned char *)(image->base + FS_BLOCK_BITMAP * FS_BLOCK_SIZE);
+    image->inodes = (fs_inode_t *)(image->base + FS_INODE_TABLE * FS_BLOCK_SIZE);
+    image->next_block = 0;
+    memset(image->delayed, 0, sizeof(image->delayed));
+    image->reserved = 0;
+    image->run_count = 0;
+    image->run_blocks = 0;
+
+    /* An image of another layout is formatted over */
+    image->formatted = image->superblock->magic != FS_MAGIC || image->superblock->version != FS_VERSION
+                       || image->superblock->block_count != FS_BLOCK_COUNT;
+    if (image->formatted)
+        fs_image_format(image);
+
+    image->superblock->mount_count++;
+    image->superblock->clean = 0;
+
+    /* A new file system is written as a whole, whereas an existing */
+    /* one only records that it is mounted, such that a crash is told */
+    fs_image_write_back(image, FS_SUPERBLOCK, image->formatted ? FS_DATA_START : 1, 1);
+}
+
+/**
+ * It commits the running transaction, writes the
+ * metadata back to the host file and marks the
+ * image as cleanly unmounted.
+ *
+ * @param image the file system image
+ */
+void fs_image_unmount(fs_image_t* image) {
+    fs_image_flush_all(image);
+    fs_journal_commit(image, FS_JOURNAL_REASON_FORCED);
+
+    /* The access times are not journaled, hence they are written here */
+    image->superblock->clean = 1;
+    fs_image_write_back(image, FS_SUPERBLOCK, FS_JOURNAL_START, 1);
+
+    if (image->fd >= 0) {
+        close(image->fd);
+        image->fd = -1;
+    }
+}
+
+/**
+ * It writes the specified blocks of the mapping back
+ * to the host file and, if sync is set, it waits for
+ * every written block to be durable. If the image is
+ * kept in anonymous memory, then nothing is done.
+ *
+ * @param image the file system image
+ * @param block the first block
+ * @param count the amount of blocks
+ * @param sync if it is 1, then the file is flushed
+ */
+void fs_image_write_back(fs_image_t* image, int block, int count, int sync) {
+    const size_t size = (size_t) count * FS_BLOCK_SIZE;
+
+    if (image->fd < 0)
+        return;
+
+    if (pwrite(image->fd, image->base + (size_t) block * FS_BLOCK_SIZE, size, (off_t) block * FS_BLOCK_SIZE)
+            != (ssize_t) size || (sync && fdatasync(image->fd) < 0)) {
+        printf("The file system image %s could not be written.\n", FS_IMAGE_PATH);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * It returns the on-disk inode with the specified inode
+ * number, straight from the mapping. If it has not been
+ * allocated yet, then it is allocated as an empty file.
+ *
+ * @param image the file system image
+ * @param inumber the inode number
+ */
+fs_inode_t* fs_image_inode(fs_image_t* image, int inumber) {
+    const int index = FS_INODE_INDEX(inumber);
+
+    if (!FS_BIT_TEST(image->inode_bitmap, index))
+        return fs_image_inode_alloc(image, index, FS_REGULAR);
+
+    return fs_image_inode_at(image, index);
+}
+
+/**
+ * It returns the on-disk inode with the specified
+ * inode number. If it has not been allocated, then
+ * NULL is returned.
+ *
+ * @param image the file system image
+ * @param inumber the inode number
+ */
+fs_inode_t* fs_image_inode_find(fs_image_t* image, int inumber) {
+    const int index = FS_INODE_INDEX(inumber);
+
+    if (index < 0 || index >= FS_INODE_COUNT || FS_INUMBER(index) != inumber
+        || !FS_BIT_TEST(image->inode_bitmap, index))
+        return NULL;
+
+    return fs_image_inode_at(image, index);
+}
+
+/**
+ * It returns the inode number of the entry with the
+ * specified name in the specified directory. If there
+ * is none, then 0 is returned.
+ *
+ * @param image the file system image
+ * @param dir the on-disk inode of the directory
+ * @param name the entry name
+ * @param reads a pointer to receive the amount of
+ *              directory blocks read
+ */
+int fs_image_dir_lookup(fs_image_t* image, const fs_inode_t* dir, const char* name, int* reads) {
+    const int count = (int) (dir->size / sizeof(fs_dirent_t));
+    const fs_dirent_t* dirents = NULL;
+    register int i;
+
+    *reads = 0;
+    for (i = 0; i < count; i++) {
+        /* It checks if the entry lies on the following block */
+        if (i % FS_DIRENTS_PER_BLOCK == 0) {
+            dirents = (const fs_dirent_t *)(image->base
+                                            + (size_t) fs_image_bmap(image, dir, i / FS_DIRENTS_PER_BLOCK) * FS_BLOCK_SIZE);
+            (*reads)++;
+        }
+
+        if (strncmp(dirents[i % FS_DIRENTS_PER_BLOCK].name, name, FS_NAME_LEN) == 0)
+            return dirents[i % FS_DIRENTS_PER_BLOCK].inumber;
+    }
+
+    return 0;
+}
+
+/**
+ * It creates an inode of the specified type and it links
+ * it into the specified directory under the specified name,
+ * which is supposed not to be taken. If there is no free
+ * inode or the directory cannot grow, then NULL is returned.
+ *
+ * @param image the file system image
+ * @param dir the on-disk inode of the directory
+ * @param name the entry name
+ * @param type the inode type
+ */
+fs_inode_t* fs_image_create(fs_image_t* image, fs_inode_t* dir, const char* name, fs_inode_type_t type) {
+    const int slot = (int) (dir->size / sizeof(fs_dirent_t));
+    fs_dirent_t* dirent;
+    fs_inode_t* inode;
+    int index;
+
+    /* The named inodes are allocated past the root, since the */
+    /* previous ones are reserved for the disk tracks */
+    for (index = FS_ROOT_INDEX + 1; index < FS_INODE_COUNT && FS_BIT_TEST(image->inode_bitmap, index); index++);
+    if (index == FS_INODE_COUNT)
+        return NULL;
+
+    /* It checks if the entry needs a new directory block */
+    if (slot / FS_DIRENTS_PER_BLOCK == dir->block_count
+        && (dir->block_count == FS_FILE_BLOCKS || fs_image_grow(image, dir, 1) == 0))
+        return NULL;
+
+    inode = fs_image_inode_alloc(image, index, type);
+
+    dirent = (fs_dirent_t *)(image->base + (size_t) fs_image_bmap(image, dir, slot / FS_DIRENTS_PER_BLOCK) * FS_BLOCK_SIZE)
+             + slot % FS_DIRENTS_PER_BLOCK;
+    fs_journal_dirty(image, dirent);
+    fs_journal_dirty(image, dir);
+    dirent->inumber = inode->id;
+    strncpy(dirent->name, name, FS_NAME_LEN);
+    dirent->name[FS_NAME_LEN - 1] = '\0';
+
+    dir->size += sizeof(fs_dirent_t);
+    time(&dir->last_modified);
+
+    return inode;
+}
+
+/**
+ * It writes a block to the specified file. It is
+ * appended while the file may still grow and there
+ * are free data blocks; otherwise, the last block of
+ * the file is overwritten. The allocation of an
+ * appended block is delayed (see FS_DELALLOC).
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ */
+void fs_image_write(fs_image_t* image, fs_inode_t* inode) {
+    const int index = FS_INODE_INDEX(inode->id);
+    const int leaf = image->delayed[index] == 0 && !inode->depth;
+    int block;
+
+    /* An appended block only reserves a data block until it is flushed. */
+    /* The first one also reserves the extent leaf the file may need */
+    if (inode->block_count + image->delayed[index] < FS_FILE_BLOCKS
+        && image->superblock->free_blocks - image->reserved > leaf) {
+        image->delayed[index]++;
+        image->reserved += 1 + leaf;
+
+        if (!FS_DELALLOC || image->delayed[index] >= FS_DELALLOC_BLOCKS)
+            fs_image_flush(image, inode);
+        return;
+    }
+
+    /* A delayed last block is overwritten in memory, */
+    /* whereas an allocated one is written in place */
+    if (image->delayed[index] == 0 && (block = fs_image_bmap(image, inode, inode->block_count - 1)) != -1) {
+        memcpy(image->base + (size_t) block * FS_BLOCK_SIZE, &inode->id, sizeof(int));
+        fs_image_write_back(image, block, 1, 0);
+    }
+}
+
+/**
+ * It allocates the delayed blocks of the specified
+ * file as contiguously as possible, and it writes
+ * them to the image. Since they have been reserved,
+ * the application is exited if they could not be.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ */
+void fs_image_flush(fs_image_t* image, fs_inode_t* inode) {
+    const int index = FS_INODE_INDEX(inode->id);
+    const int count = image->delayed[index];
+
+    if (count == 0)
+        return;
+
+    /* The reservation (see fs_image_write) is handed over to the allocation */
+    image->delayed[index] = 0;
+    image->reserved -= count + !inode->depth;
+
+    /* It checks if some accepted write could not be allocated */
+    if (fs_image_grow(image, inode, count) < count) {
+        printf("The delayed blocks of the inode %d could not be allocated.\n", inode->id);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * It allocates the delayed blocks of every file,
+ * each one in a journal operation of its own.
+ *
+ * @param image the file system image
+ */
+void fs_image_flush_all(fs_image_t* image) {
+    register int index;
+
+    for (index = 0; index < FS_INODE_COUNT && image->reserved > 0; index++) {
+        if (image->delayed[index] == 0)
+            continue;
+
+        fs_journal_begin(image, FS_JOURNAL_GROW_CREDITS);
+        fs_image_flush(image, fs_image_inode_at(image, index));
+        fs_journal_end(image);
+    }
+}
+
+/**
+ * It returns the image block the specified file
+ * block is mapped to. If it is not mapped, then
+ * -1 is returned.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param logical the file block
+ */
+int fs_image_bmap(fs_image_t* image, const fs_inode_t* inode, int logical) {
+    const fs_extent_t* extents;
+    int leaf = FS_EXTENT_LEAVES(inode) - 1;
+    int count;
+    register int i;
+
+    if (logical < 0 || logical >= inode->block_count)
+        return -1;
+
+    /* It descends to the leaf holding the block */
+    if (inode->depth)
+        while (leaf > 0 && inode->extents[leaf].logical > logical)
+            leaf--;
+
+    extents = fs_image_extent_leaf(image, inode, leaf, &count);
+    for (i = count - 1; i >= 0; i--)
+        if (extents[i].logical <= logical)
+            return logical < extents[i].logical + extents[i].length
+                   ? extents[i].start + logical - extents[i].logical : -1;
+
+    return -1;
+}
+
+/**
+ * It prints the usage of the file system image,
+ * the runs handed out by the allocator and the
+ * fragmentation of the most fragmented files.
+ *
+ * @param image the file system image
+ * @param fp the file to be printed to
+ */
+void fs_image_report(fs_image_t* image, FILE* fp) {
+    const fs_superblock_t* sb = image->superblock;
+    fs_file_frag_t files[FS_INODE_COUNT];
+    const fs_extent_t* extents;
+    int file_count = 0;
+    int block_count = 0;
+    int extent_count = 0;
+    int fragmented = 0;
+    long distance = 0;
+    int free_runs = 0;
+    int largest = 0;
+    int run = 0;
+    int count;
+    int end;
+    int leaf;
+    register int i;
+    register int j;
+
+    fprintf(fp, "File system image %s (%s, mount %d%s): %d/%d inodes, %d/%d data blocks "
+                "(%d kb) in use\n",
+            FS_IMAGE_PATH, image->fd >= 0 ? "host file" : "anonymous memory", sb->mount_count,
+            image->formatted ? ", formatted" : "",
+            sb->inode_count - sb->free_inodes, sb->inode_count,
+            FS_DATA_BLOCK_COUNT - sb->free_blocks, FS_DATA_BLOCK_COUNT,
+            (FS_DATA_BLOCK_COUNT - sb->free_blocks) * (FS_BLOCK_SIZE >> 10));
+
+    /* It measures the free space by its runs */
+    for (i = 0; i < FS_DATA_BLOCK_COUNT; i++) {
+        if (FS_BIT_TEST(image->block_bitmap, i)) {
+            run = 0;
+            continue;
+        }
+
+        if (run++ == 0)
+            free_runs++;
+        if (run > largest)
+            largest = run;
+    }
+
+    fprintf(fp, "Allocator (delayed allocation %s): %ld runs handed out (%.1f blocks/run), "
+                "free space in %d runs (largest %d blocks)\n",
+            FS_DELALLOC ? "on" : "off", image->run_count,
+            image->run_count ? (double) image->run_blocks / image->run_count : 0.0, free_runs, largest);
+
+    /* It walks the extents of every file, as if it were read sequentially */
+    for (i = 0; i < FS_INODE_COUNT; i++) {
+        fs_inode_t* inode = fs_image_inode_at(image, i);
+        fs_file_frag_t* file = &files[file_count];
+
+        if (!FS_BIT_TEST(image->inode_bitmap, i) || inode->block_count == 0)
+            continue;
+
+        file->inumber = inode->id;
+        file->type = inode->type;
+        file->blocks = inode->block_count;
+        file->extents = 0;
+        file->distance = 0;
+
+        for (end = -1, leaf = 0; leaf < FS_EXTENT_LEAVES(inode); leaf++) {
+            extents = fs_image_extent_leaf(image, inode, leaf, &count);
+
+            for (j = 0; j < count; j++) {
+                if (end != -1)
+                    file->distance += labs((long) extents[j].start - end);
+                end = extents[j].start + extents[j].length;
+            }
+            file->extents += count;
+        }
+
+        file_count++;
+        block_count += file->blocks;
+        extent_count += file->extents;
+        fragmented += file->extents > 1;
+        distance += file->distance;
+    }
+
+    fprintf(fp, "Fragmentation: %d files, %d blocks in %d extents (%.2f/file), %d fragmented, "
+                "%ld blocks sought\n",
+            file_count, block_count, extent_count,
+            file_count ? (double) extent_count / file_count : 0.0, fragmented, distance);
+
+    if (file_count == 0)
+        return;
+
+    qsort(files, file_count, sizeof(fs_file_frag_t), fs_file_frag_cmp);
+
+    fprintf(fp, "%-12s %-9s %8s %8s %8s %10s\n", "Inode", "Type", "Blocks", "Extents", "Seeks", "Distance");
+    for (i = 0; i < file_count && i < FS_REPORT_FILES; i++)
+        fprintf(fp, "%-12d %-9s %8d %8d %8d %10ld\n", files[i].inumber,
+                files[i].type == FS_DIRECTORY ? "directory" : "regular",
+                files[i].blocks, files[i].extents, files[i].extents - 1, files[i].distance);
+}
+
+/* Internal File System Image Function Definitions */
+
+/**
+ * It returns the specified entry of the
+ * inode table, straight from the mapping.
+ *
+ * @param image the file system image
+ * @param index the inode table entry
+ */
+static fs_inode_t* fs_image_inode_at(fs_image_t* image, int index) {
+    return (fs_inode_t *)((char *) image->inodes + (size_t) index * FS_INODE_SIZE);
+}
+
+/**
+ * It allocates the specified entry of the inode
+ * table as an empty inode of the specified type.
+ *
+ * @param image the file system image
+ * @param index the inode table entry
+ * @param type the inode type
+ */
+static fs_inode_t* fs_image_inode_alloc(fs_image_t* image, int index, fs_inode_type_t type) {
+    fs_inode_t* inode = fs_image_inode_at(image, index);
+
+    fs_journal_dirty(image, &image->inode_bitmap[index >> 3]);
+    fs_journal_dirty(image, image->superblock);
+    fs_journal_dirty(image, inode);
+
+    FS_BIT_SET(image->inode_bitmap, index);
+    image->superblock->free_inodes--;
+
+    memset(inode, 0, FS_INODE_SIZE);
+    inode->id = FS_INUMBER(index);
+    inode->mode = F_PERM_OWNER_R | F_PERM_OWNER_W | F_PERM_OWNER_X | F_PERM_OTHER_R | F_PERM_OTHER_W;
+    inode->type = type;
+    inode->last_accessed = -1;
+    inode->last_modified = -1;
+
+    return inode;
+}
+
+/**
+ * It writes an empty file system onto the image,
+ * that is, the superblock and both bitmaps cleared.
+ *
+ * @param image the file system image
+ */
+static void fs_image_format(fs_image_t* image) {
+    fs_superblock_t* sb = image->superblock;
+
+    memset(image->base, 0, (size_t) FS_DATA_START * FS_BLOCK_SIZE);
+
+    sb->magic = FS_MAGIC;
+    sb->version = FS_VERSION;
+    sb->block_size = FS_BLOCK_SIZE;
+    sb->block_count = FS_BLOCK_COUNT;
+    sb->inode_count = FS_INODE_COUNT;
+    sb->inode_bitmap = FS_INODE_BITMAP;
+    sb->block_bitmap = FS_BLOCK_BITMAP;
+    sb->inode_table = FS_INODE_TABLE;
+    sb->data_start = FS_DATA_START;
+    sb->free_inodes = FS_INODE_COUNT;
+    sb->free_blocks = FS_DATA_BLOCK_COUNT;
+    sb->mount_count = 0;
+    sb->clean = 1;
+
+    fs_image_inode_alloc(image, FS_ROOT_INDEX, FS_DIRECTORY);
+}
+
+/**
+ * It allocates a run of up to count free data blocks
+ * and it returns its first block within the image, its
+ * length being stored in length. The run starts at the
+ * goal if it is free; otherwise, the first run as long
+ * as requested past it is taken, or the longest one if
+ * there is none. The blocks reserved by the delayed
+ * writes are left free, hence if no other block is
+ * free, then -1 is returned. The bitmap bytes it sets
+ * lie on a single block (see FS_JOURNAL_SHARED_CREDITS).
+ *
+ * @param image the file system image
+ * @param goal the data block the search starts at,
+ *             or -1 to start past the last run
+ * @param count the amount of blocks requested
+ * @param length a pointer to receive the length
+ */
+static int fs_image_extent_alloc(fs_image_t* image, int goal, int count, int* length) {
+    const int from = goal >= 0 && goal < FS_DATA_BLOCK_COUNT ? goal : image->next_block;
+    int best = -1;
+    int best_length = 0;
+    const int available = image->superblock->free_blocks - image->reserved;
+    int run = 0;
+    register int i;
+    int block;
+
+    if (available <= 0)
+        return -1;
+
+    if (count > available)
+        count = available;
+
+    /* A run may not wrap around the end of the data blocks */
+    for (i = 0; i < FS_DATA_BLOCK_COUNT && best_length < count; i++) {
+        block = (from + i) % FS_DATA_BLOCK_COUNT;
+
+        if (block == 0)
+            run = 0;
+
+        if (FS_BIT_TEST(image->block_bitmap, block))
+            run = 0;
+        else if (++run > best_length) {
+            best = block - run + 1;
+            best_length = run;
+        }
+    }
+
+    *length = best_length < count ? best_length : count;
+
+    fs_journal_dirty(image, image->superblock);
+    for (block = best; block < best + *length; block++) {
+        fs_journal_dirty(image, &image->block_bitmap[block >> 3]);
+        FS_BIT_SET(image->block_bitmap, block);
+    }
+
+    image->superblock->free_blocks -= *length;
+    image->next_block = (best + *length) % FS_DATA_BLOCK_COUNT;
+
+    return best + FS_DATA_START;
+}
+
+/**
+ * It frees the specified run of data blocks.
+ *
+ * @param image the file system image
+ * @param start the first block within the image
+ * @param length the amount of blocks
+ */
+static void fs_image_extent_free(fs_image_t* image, int start, int length) {
+    register int block;
+
+    fs_journal_dirty(image, image->superblock);
+    for (block = start - FS_DATA_START; block < start - FS_DATA_START + length; block++) {
+        fs_journal_dirty(image, &image->block_bitmap[block >> 3]);
+        FS_BIT_CLEAR(image->block_bitmap, block);
+    }
+
+    image->superblock->free_blocks += length;
+}
+
+/**
+ * It returns the extents of the specified leaf of
+ * the extent tree of a file, and it stores their
+ * amount in count.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param leaf the leaf (see FS_EXTENT_LEAVES)
+ * @param count a pointer to receive the amount
+ */
+static fs_extent_t* fs_image_extent_leaf(fs_image_t* image, const fs_inode_t* inode, int leaf, int* count) {
+    fs_extent_leaf_t* block;
+
+    if (!inode->depth) {
+        *count = inode->extent_count;
+        return (fs_extent_t *) inode->extents;
+    }
+
+    block = (fs_extent_leaf_t *)(image->base + (size_t) inode->extents[leaf].start * FS_BLOCK_SIZE);
+    *count = block->count;
+
+    return block->extents;
+}
+
+/**
+ * It maps the specified run of data blocks past the
+ * end of a file, merging it with the last extent if
+ * they are contiguous. A leaf block is allocated if
+ * the tree is full. If it could not be, then 0 is
+ * returned; otherwise, 1 is returned.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param start the first block within the image
+ * @param length the amount of blocks
+ */
+static int fs_image_extent_append(fs_image_t* image, fs_inode_t* inode, int start, int length) {
+    fs_extent_t* index = inode->depth ? &inode->extents[inode->extent_count - 1] : NULL;
+    fs_extent_leaf_t* leaf = NULL;
+    fs_extent_t* extents;
+    int* count;
+    int block;
+    int unused;
+
+    fs_journal_dirty(image, inode);
+
+    if (index) {
+        leaf = (fs_extent_leaf_t *)(image->base + (size_t) index->start * FS_BLOCK_SIZE);
+        extents = leaf->extents;
+        count = &leaf->count;
+    } else {
+        extents = inode->extents;
+        count = &inode->extent_count;
+    }
+
+    /* It checks if the run goes on right past the last extent */
+    if (*count > 0 && extents[*count - 1].start + extents[*count - 1].length == start) {
+        if (leaf) {
+            fs_journal_dirty(image, leaf);
+            index->length += length;
+        }
+
+        extents[*count - 1].length += length;
+        return 1;
+    }
+
+    /* It checks if the last leaf is full, hence a new one is needed. */
+    /* The extents of the inode itself are moved into the first one */
+    if (*count == (leaf ? FS_LEAF_EXTENTS : FS_INODE_EXTENTS)) {
+        if ((leaf && inode->extent_count == FS_INODE_EXTENTS)
+            || (block = fs_image_extent_alloc(image, -1, 1, &unused)) == -1)
+            return 0;
+
+        leaf = (fs_extent_leaf_t *)(image->base + (size_t) block * FS_BLOCK_SIZE);
+        fs_journal_dirty(image, leaf);
+        memset(leaf, 0, FS_BLOCK_SIZE);
+
+        if (!inode->depth) {
+            memcpy(leaf->extents, inode->extents, sizeof(fs_extent_t) * inode->extent_count);
+            leaf->count = inode->extent_count;
+            inode->depth = 1;
+            inode->extent_count = 0;
+        }
+
+        index = &inode->extents[inode->extent_count++];
+        index->logical = leaf->count ? leaf->extents[0].logical : inode->block_count;
+        index->start = block;
+        index->length = leaf->count ? inode->block_count - index->logical : 0;
+        extents = leaf->extents;
+        count = &leaf->count;
+    }
+
+    if (leaf) {
+        fs_journal_dirty(image, leaf);
+        index->length += length;
+    }
+
+    extents[*count].logical = inode->block_count;
+    extents[*count].start = start;
+    extents[*count].length = length;
+    (*count)++;
+
+    return 1;
+}
+
+/**
+ * It allocates and maps the specified amount of blocks
+ * past the end of a file, in as few runs as possible,
+ * starting right past its last extent. The blocks of
+ * a regular file are written to the image as well. It
+ * returns the amount of blocks mapped.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param count the amount of blocks
+ */
+static int fs_image_grow(fs_image_t* image, fs_inode_t* inode, int count) {
+    int mapped = 0;
+    int start;
+    int length;
+    int last;
+    register int block;
+
+    while (mapped < count) {
+        /* The file goes on right past its last block if it may */
+        last = fs_image_bmap(image, inode, inode->block_count - 1);
+
+        if ((start = fs_image_extent_alloc(image, last == -1 ? -1 : last + 1 - FS_DATA_START,
+                                           count - mapped, &length)) == -1)
+            break;
+
+        /* A run starting a new extent is followed by a window left */
+        /* for the file to grow into, such that the runs of files */
+        /* written at once are not laid out one right after another */
+        if (start != last + 1)
+            image->next_block = (image->next_block + FS_DELALLOC_BLOCKS) % FS_DATA_BLOCK_COUNT;
+
+        if (!fs_image_extent_append(image, inode, start, length)) {
+            fs_image_extent_free(image, start, length);
+            break;
+        }
+
+        inode->block_count += length;
+        mapped += length;
+        image->run_count++;
+        image->run_blocks += length;
+
+        /* A written block holds its inode number, such that the image */
+        /* contents may be told apart across runs. The data is written */
+        /* straight away, hence before the metadata referring to it */
+        if (inode->type == FS_REGULAR) {
+            for (block = start; block < start + length; block++)
+                memcpy(image->base + (size_t) block * FS_BLOCK_SIZE, &inode->id, sizeof(int));
+
+            fs_image_write_back(image, start, length, 0);
+            inode->size += (long) length * FS_BLOCK_SIZE;
+        }
+    }
+
+    return mapped;
+}
+
+/**
+ * It compares the fragmentation of two files by
+ * their extents and their distance, in descending
+ * order.
+ */
+static int fs_file_frag_cmp(const void* f1, const void* f2) {
+    const fs_file_frag_t* file1 = (const fs_file_frag_t *) f1;
+    const fs_file_frag_t* file2 = (const fs_file_frag_t *) f2;
+
+    if (file1->extents != file2->extents)
+        return file2->extents - file1->extents;
+
+    return (file2->distance > file1->distance) - (file2->distance < file1->distance);
+}
@@ -0,0 +1,418 @@
+#ifndef OS_PROJECT_FS_IMAGE_H
+#define OS_PROJECT_FS_IMAGE_H
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * If it is set, then the file system is kept in a
+ * host file, such that its inodes and data blocks
+ * survive across runs. Otherwise, the very same
+ * layout is kept in anonymous memory, such that
+ * no file is created unless it is asked for.
+ */
+#define FS_IMAGE (0)
+#define FS_IMAGE_PATH "ribabari.fs"
+
+/**
+ * It identifies a formatted file system image
+ * and the version of its layout.
+ */
+#define FS_MAGIC (0x52494246)
+#define FS_VERSION (4)
+
+/**
+ * It represents the size (bytes) of a file system
+ * block, that is, the size of a disk request (see
+ * DISK_REQUEST_SECTORS), the size of an on-disk
+ * inode and the amount of blocks a file may hold.
+ */
+#define FS_BLOCK_SIZE (4096)
+#define FS_INODE_SIZE (128)
+#define FS_FILE_BLOCKS (64)
+
+/**
+ * If it is set, then the blocks written to a file are
+ * only allocated once FS_DELALLOC_BLOCKS of them have
+ * been gathered, the file is closed or the file system
+ * is synced, such that they are handed out as a single
+ * run. Otherwise, each block is allocated when written.
+ */
+#define FS_DELALLOC (1)
+#define FS_DELALLOC_BLOCKS (16)
+
+/**
+ * It represents the amount of extents held by
+ * an inode itself, the amount of them held by
+ * a leaf block, and the amount of files listed
+ * by the fragmentation report.
+ */
+#define FS_INODE_EXTENTS (4)
+#define FS_LEAF_EXTENTS ((FS_BLOCK_SIZE - (int) sizeof(int)) / (int) sizeof(fs_extent_t))
+#define FS_REPORT_FILES (10)
+
+/**
+ * It represents the amount of inodes, such that
+ * there is one for each disk track followed by
+ * those of the named files, and the amount of
+ * data blocks.
+ */
+#define FS_INODE_COUNT (512)
+#define FS_DATA_BLOCK_COUNT (2048)
+
+/**
+ * It represents the layout of the image, that is,
+ * the block of the superblock, those of both bitmaps,
+ * the first block of the inode table, the first block
+ * of the journal and the first data block.
+ */
+#define FS_SUPERBLOCK (0)
+#define FS_INODE_BITMAP (1)
+#define FS_BLOCK_BITMAP (2)
+#define FS_INODE_TABLE (3)
+#define FS_INODE_TABLE_BLOCKS (FS_INODE_COUNT * FS_INODE_SIZE / FS_BLOCK_SIZE)
+#define FS_JOURNAL_START (FS_INODE_TABLE + FS_INODE_TABLE_BLOCKS)
+#define FS_JOURNAL_BLOCKS (64)
+#define FS_DATA_START (FS_JOURNAL_START + FS_JOURNAL_BLOCKS)
+#define FS_BLOCK_COUNT (FS_DATA_START + FS_DATA_BLOCK_COUNT)
+
+#include "journal.h"
+
+/**
+ * It represents the maximum length of a
+ * name, including its terminator, and the
+ * amount of directory entries in a block.
+ */
+#define FS_NAME_LEN (28)
+#define FS_DIRENTS_PER_BLOCK (FS_BLOCK_SIZE / (int) sizeof(fs_dirent_t))
+
+/**
+ * It calculates the inode table entry of an inode
+ * from its inode number (see INODE_NUMBER), that
+ * is, the disk track the inode lies on for the
+ * first ones, and the inode number of an entry.
+ */
+#define FS_INODE_INDEX(inumber) (INVERSE_DISK_BLOCK(INVERSE_INODE_NUMBER(inumber)))
+#define FS_INUMBER(index) (INODE_NUMBER(DISK_BLOCK(index)))
+
+/**
+ * It represents the inode table entry of the root
+ * directory, that is, the first one past the disk
+ * tracks, and its inode number.
+ */
+#define FS_ROOT_INDEX (DISK_TRACK_LIMIT + 1)
+#define FS_ROOT_INUMBER (FS_INUMBER(FS_ROOT_INDEX))
+
+/**
+ * It represents the available inode types.
+ */
+typedef enum FileSystemInodeType {
+    FS_REGULAR,
+    FS_DIRECTORY
+} fs_inode_type_t;
+
+typedef struct FileSystemSuperblock {
+    /**
+     * It holds the magic number and the
+     * version of the layout.
+     */
+    unsigned int magic;
+    int version;
+
+    /**
+     * It holds the layout of the image
+     * (see FS_BLOCK_COUNT).
+     */
+    int block_size;
+    int block_count;
+    int inode_count;
+    int inode_bitmap;
+    int block_bitmap;
+    int inode_table;
+    int data_start;
+
+    /**
+     * It holds the amount of inodes and
+     * of data blocks not allocated yet.
+     */
+    int free_inodes;
+    int free_blocks;
+
+    /**
+     * It holds the amount of times the image
+     * has been mounted and whether it has been
+     * unmounted cleanly since the last mount.
+     */
+    int mount_count;
+    int clean;
+} fs_superblock_t;
+
+typedef struct FileSystemExtent {
+    /**
+     * It holds the first file block the extent
+     * maps, the first image block it is mapped
+     * to and the amount of blocks. An index
+     * entry maps every block of the extents held
+     * by its leaf block instead.
+     */
+    int logical;
+    int start;
+    int length;
+} fs_extent_t;
+
+typedef struct FileSystemExtentLeaf {
+    /**
+     * It holds the amount of extents
+     * and the extents themselves.
+     */
+    int count;
+    fs_extent_t extents[FS_LEAF_EXTENTS];
+} fs_extent_leaf_t;
+
+typedef struct FileSystemInode {
+    /**
+     * It represents the inode number or
+     * 0 if the inode is not allocated.
+     */
+    int id;
+
+    /**
+     * It contains the file mode (see
+     * file_perm_t).
+     */
+    short mode;
+
+    /**
+     * It holds the inode type (see
+     * fs_inode_type_t).
+     */
+    short type;
+
+    /**
+     * It holds the file size measured
+     * in bytes.
+     */
+    long size;
+
+    /**
+     * It contains the time when this file
+     * has been last accessed and modified.
+     */
+    time_t last_accessed;
+    time_t last_modified;
+
+    /**
+     * It holds the amount of data blocks
+     * mapped by the file.
+     */
+    int block_count;
+
+    /**
+     * It holds the root of the extent tree, that
+     * is, its depth and its entries. The entries
+     * are the extents of the file themselves if
+     * the depth is 0; otherwise, they are index
+     * entries of the leaf blocks.
+     */
+    int depth;
+    int extent_count;
+    fs_extent_t extents[FS_INODE_EXTENTS];
+} fs_inode_t;
+
+typedef struct FileSystemDirectoryEntry {
+    /**
+     * It holds the inode number of the entry
+     * and its name (NUL-terminated).
+     */
+    int inumber;
+    char name[FS_NAME_LEN];
+} fs_dirent_t;
+
+typedef struct FileSystemImage {
+    /**
+     * It holds the host file descriptor or -1
+     * if the image is kept in anonymous memory.
+     */
+    int fd;
+
+    /**
+     * It holds the mapping of the image and
+     * each region of the layout within it.
+     */
+    char* base;
+    fs_superblock_t* superblock;
+    unsigned char* inode_bitmap;
+    unsigned char* block_bitmap;
+    fs_inode_t* inodes;
+
+    /**
+     * It holds the data block the next
+     * allocation starts searching at.
+     */
+    int next_block;
+
+    /**
+     * It holds the amount of blocks written to each
+     * file (by inode table entry) whose allocation
+     * has been delayed, and their total amount, which
+     * is reserved out of the free data blocks along
+     * with an extent leaf for each of these files.
+     */
+    int delayed[FS_INODE_COUNT];
+    int reserved;
+
+    /**
+     * It holds the amount of runs of data blocks
+     * handed out and the amount of blocks in them.
+     */
+    long run_count;
+    long run_blocks;
+
+    /**
+     * It is set if the image has been
+     * formatted when it was mounted.
+     */
+    int formatted;
+
+    /**
+     * It holds the journal of the
+     * metadata updates.
+     */
+    fs_journal_t journal;
+} fs_image_t;
+
+/* File System Image Function Prototypes */
+
+/**
+ * It maps the file system image into memory, and it
+ * formats it if it does not hold a file system yet.
+ * The mapping is private, such that the metadata only
+ * reaches the host file through the journal. If the
+ * image could not be mapped, then the application is
+ * exited.
+ *
+ * @param image the file system image
+ */
+void fs_image_mount(fs_image_t* image);
+
+/**
+ * It commits the running transaction, writes the
+ * metadata back to the host file and marks the
+ * image as cleanly unmounted.
+ *
+ * @param image the file system image
+ */
+void fs_image_unmount(fs_image_t* image);
+
+/**
+ * It returns the on-disk inode with the specified inode
+ * number, straight from the mapping. If it has not been
+ * allocated yet, then it is allocated as an empty file.
+ *
+ * @param image the file system image
+ * @param inumber the inode number
+ */
+fs_inode_t* fs_image_inode(fs_image_t* image, int inumber);
+
+/**
+ * It returns the on-disk inode with the specified
+ * inode number. If it has not been allocated, then
+ * NULL is returned.
+ *
+ * @param image the file system image
+ * @param inumber the inode number
+ */
+fs_inode_t* fs_image_inode_find(fs_image_t* image, int inumber);
+
+/**
+ * It returns the inode number of the entry with the
+ * specified name in the specified directory. If there
+ * is none, then 0 is returned.
+ *
+ * @param image the file system image
+ * @param dir the on-disk inode of the directory
+ * @param name the entry name
+ * @param reads a pointer to receive the amount of
+ *              directory blocks read
+ */
+int fs_image_dir_lookup(fs_image_t* image, const fs_inode_t* dir, const char* name, int* reads);
+
+/**
+ * It creates an inode of the specified type and it links
+ * it into the specified directory under the specified name,
+ * which is supposed not to be taken. If there is no free
+ * inode or the directory cannot grow, then NULL is returned.
+ *
+ * @param image the file system image
+ * @param dir the on-disk inode of the directory
+ * @param name the entry name
+ * @param type the inode type
+ */
+fs_inode_t* fs_image_create(fs_image_t* image, fs_inode_t* dir, const char* name, fs_inode_type_t type);
+
+/**
+ * It writes a block to the specified file. It is
+ * appended while the file may still grow and there
+ * are free data blocks; otherwise, the last block of
+ * the file is overwritten. The allocation of an
+ * appended block is delayed (see FS_DELALLOC).
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ */
+void fs_image_write(fs_image_t* image, fs_inode_t* inode);
+
+/**
+ * It allocates the delayed blocks of the specified
+ * file as contiguously as possible, and it writes
+ * them to the image. Since they have been reserved,
+ * the application is exited if they could not be.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ */
+void fs_image_flush(fs_image_t* image, fs_inode_t* inode);
+
+/**
+ * It allocates the delayed blocks of every file,
+ * each one in a journal operation of its own.
+ *
+ * @param image the file system image
+ */
+void fs_image_flush_all(fs_image_t* image);
+
+/**
+ * It returns the image block the specified file
+ * block is mapped to. If it is not mapped, then
+ * -1 is returned.
+ *
+ * @param image the file system image
+ * @param inode the on-disk inode
+ * @param logical the file block
+ */
+int fs_image_bmap(fs_image_t* image, const fs_inode_t* inode, int logical);
+
+/**
+ * It writes the specified blocks of the mapping back
+ * to the host file and, if sync is set, it waits for
+ * every written block to be durable. If the image is
+ * kept in anonymous memory, then nothing is done.
+ *
+ * @param image the file system image
+ * @param block the first block
+ * @param count the amount of blocks
+ * @param sync if it is 1, then the file is flushed
+ */
+void fs_image_write_back(fs_image_t* image, int block, int count, int sync);
+
+/**
+ * It prints the usage of the file system image,
+ * the runs handed out by the allocator and the
+ * fragmentation of the most fragmented files.
+ *
+ * @param image the file system image
+ * @param fp the file to be printed to
+ */
+void fs_image_report(fs_image_t* image, FILE* fp);
+
+#endif // OS_PROJECT_FS_IMAGE_H
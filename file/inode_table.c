@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "file.h"
+
+/* Internal Inode Table Function Prototypes */
+
+/**
+ * It returns the home slot of the specified inode
+ * number, that is, the slot its probing starts at.
+ * The inode numbers are spread by a multiplicative
+ * hash, since they grow in a fixed stride.
+ *
+ * @param itable the inode table
+ * @param inumber the inode number
+ */
+static int itable_slot(const itable_t* itable, int inumber);
+
+/**
+ * It allocates the specified amount of (empty) slots.
+ * If there is not enough memory to allocate them,
+ * then the application is exited.
+ *
+ * @param capacity the amount of slots
+ */
+static inode_t** itable_slots_create(int capacity);
+
+/* Inode Table Function Definitions */
+
+/**
+ * It initializes the inode table. If there is
+ * not enough memory to allocate its slots, then
+ * the application is exited.
+ *
+ * @param itable the inode table
+ */
+void itable_init(itable_t* itable) {
+    itable->slots = itable_slots_create(INODE_TABLE_INITIAL_CAPACITY);
+    itable->capacity = INODE_TABLE_INITIAL_CAPACITY;
+    itable->size = 0;
+}
+
+/**
+ * It returns the inode with the specified inode
+ * number. If there is none, then NULL is returned.
+ *
+ * @param itable the inode table
+ * @param inumber the inode number
+ */
+inode_t* itable_find(const itable_t* itable, int inumber) {
+    const int mask = itable->capacity - 1;
+    int slot;
+
+    /* The probing stops at the first empty slot, since no */
+    /* removal leaves a hole within a cluster of inodes */
+    for (slot = itable_slot(itable, inumber); itable->slots[slot]; slot = (slot + 1) & mask)
+        if (itable->slots[slot]->id == inumber)
+            return itable->slots[slot];
+
+    return NULL;
+}
+
+/**
+ * It inserts the specified inode, which is supposed
+ * not to be in the table yet. The table doubles its
+ * slots once it gets too loaded.
+ *
+ * @param itable the inode table
+ * @param inode the inode
+ */
+void itable_insert(itable_t* itable, inode_t* inode) {
+    int slot;
+    register int i;
+
+    /* It checks if the table is too loaded, hence every */
+    /* inode is rehashed into twice as many slots */
+    if ((itable->size + 1) * 100 > itable->capacity * INODE_TABLE_MAX_LOAD) {
+        inode_t** slots = itable->slots;
+        const int capacity = itable->capacity;
+
+        itable->slots = itable_slots_create(capacity << 1);
+        itable->capacity = capacity << 1;
+        itable->size = 0;
+
+        for (i = 0; i < capacity; i++)
+            if (slots[i])
+                itable_insert(itable, slots[i]);
+        free(slots);
+    }
+
+    for (slot = itable_slot(itable, inode->id); itable->slots[slot]; slot = (slot + 1) & (itable->capacity - 1));
+
+    itable->slots[slot] = inode;
+    itable->size++;
+}
+
+/**
+ * It removes the inode with the specified inode
+ * number and it returns it. If there is none,
+ * then NULL is returned.
+ *
+ * @param itable the inode table
+ * @param inumber the inode number
+ */
+inode_t* itable_remove(itable_t* itable, int inumber) {
+    const int mask = itable->capacity - 1;
+    inode_t* inode;
+    int hole;
+    int slot;
+    int home;
+
+    for (hole = itable_slot(itable, inumber); itable->slots[hole]; hole = (hole + 1) & mask)
+        if (itable->slots[hole]->id == inumber)
+            break;
+
+    if (!(inode = itable->slots[hole]))
+        return NULL;
+
+    /* Each following inode of the cluster is shifted back into */
+    /* the hole, unless its home slot lies after the hole, such */
+    /* that every inode stays reachable from its home slot */
+    for (slot = (hole + 1) & mask; itable->slots[slot]; slot = (slot + 1) & mask) {
+        home = itable_slot(itable, itable->slots[slot]->id);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            itable->slots[hole] = itable->slots[slot];
+            hole = slot;
+        }
+    }
+
+    itable->slots[hole] = NULL;
+    itable->size--;
+    return inode;
+}
+
+/* Internal Inode Table Function Definitions */
+
+/**
+ * It returns the home slot of the specified inode
+ * number, that is, the slot its probing starts at.
+ * The inode numbers are spread by a multiplicative
+ * hash, since they grow in a fixed stride.
+ *
+ * @param itable the inode table
+ * @param inumber the inode number
+ */
+static int itable_slot(const itable_t* itable, int inumber) {
+    unsigned hash = (unsigned) inumber * 2654435761u;
+
+    /* The high bits are folded into the low ones, which are */
+    /* otherwise the same for every inode number of a stride */
+    return (int) (hash ^ (hash >> 16)) & (itable->capacity - 1);
+}
+
+/**
+ * It allocates the specified amount of (empty) slots.
+ * If there is not enough memory to allocate them,
+ * then the application is exited.
+ *
+ * @param capacity the amount of slots
+ */
+static inode_t** itable_slots_create(int capacity) {
+    inode_t** slots = (inode_t **)calloc(capacity, sizeof(inode_t *));
+
+    /* It checks if the slots could not be allocated */
+    if (!slots) {
+        printf("Not enough memory to allocate the inode table.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return slots;
+}
@@ -0,0 +1,83 @@
+#ifndef OS_PROJECT_INODE_TABLE_H
+#define OS_PROJECT_INODE_TABLE_H
+
+/**
+ * It represents an inode (see file.h).
+ */
+typedef struct Inode inode_t;
+
+/**
+ * It represents the initial amount of slots
+ * of the inode table (a power of two).
+ */
+#define INODE_TABLE_INITIAL_CAPACITY (64)
+
+/**
+ * It represents the maximum fraction of slots
+ * in use, in percent, before the table grows.
+ */
+#define INODE_TABLE_MAX_LOAD (70)
+
+/**
+ * An open-addressing hash table of the active
+ * inodes keyed by their inode number. A colliding
+ * inode takes the next free slot (linear probing)
+ * and a removal shifts the following inodes back,
+ * such that no tombstone is ever left behind.
+ */
+typedef struct InodeTable {
+    /**
+     * It holds the slots, each of them
+     * pointing to an inode or NULL, and
+     * their amount (a power of two).
+     */
+    inode_t** slots;
+    int capacity;
+
+    /**
+     * It holds the amount of inodes.
+     */
+    int size;
+} itable_t;
+
+/* Inode Table Function Prototypes */
+
+/**
+ * It initializes the inode table. If there is
+ * not enough memory to allocate its slots, then
+ * the application is exited.
+ *
+ * @param itable the inode table
+ */
+void itable_init(itable_t* itable);
+
+/**
+ * It returns the inode with the specified inode
+ * number. If there is none, then NULL is returned.
+ *
+ * @param itable the inode table
+ * @param inumber the inode number
+ */
+inode_t* itable_find(const itable_t* itable, int inumber);
+
+/**
+ * It inserts the specified inode, which is supposed
+ * not to be in the table yet. The table doubles its
+ * slots once it gets too loaded.
+ *
+ * @param itable the inode table
+ * @param inode the inode
+ */
+void itable_insert(itable_t* itable, inode_t* inode);
+
+/**
+ * It removes the inode with the specified inode
+ * number and it returns it. If there is none,
+ * then NULL is returned.
+ *
+ * @param itable the inode table
+ * @param inumber the inode number
+ */
+inode_t* itable_remove(itable_t* itable, int inumber);
+
+#endif // OS_PROJECT_INODE_TABLE_H
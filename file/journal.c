@@ -0,0 +1,357 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fs_image.h"
+
+_Static_assert(sizeof(fs_journal_header_t) <= FS_BLOCK_SIZE, "A journal header must fit in a block");
+
+/**
+ * It tests and sets the bit of the
+ * specified block in a bitmap.
+ */
+#define FS_JOURNAL_TEST(bitmap, i) ((bitmap)[(i) >> 3] & (1 << ((i) & 7)))
+#define FS_JOURNAL_SET(bitmap, i) ((bitmap)[(i) >> 3] |= (1 << ((i) & 7)))
+
+/* Internal File System Journal Function Prototypes */
+
+/**
+ * It returns the current time in nanoseconds.
+ */
+static long fs_journal_now_ns();
+
+/**
+ * It returns the checksum (FNV-1a) of the
+ * specified amount of blocks.
+ *
+ * @param blocks the blocks
+ * @param count the amount of blocks
+ */
+static unsigned int fs_journal_checksum(const char* blocks, int count);
+
+/**
+ * It replays the last transaction of the journal onto
+ * the home blocks of the image, provided that it has
+ * been sealed by its commit block.
+ *
+ * @param image the file system image
+ */
+static void fs_journal_replay(fs_image_t* image);
+
+/* File System Journal Function Definitions */
+
+/**
+ * It initializes the journal and, if the image has
+ * not been unmounted cleanly, it replays its last
+ * transaction onto the home blocks. It is supposed
+ * to be invoked before the image is mapped.
+ *
+ * @param image the file system image
+ * @param clean if it is 0, the image has not been
+ *              unmounted cleanly
+ */
+void fs_journal_init(fs_image_t* image, int clean) {
+    fs_journal_t* journal = &image->journal;
+    register int i;
+
+    memset(journal->dirty, 0, sizeof(journal->dirty));
+    journal->block_count = 0;
+    journal->handle_count = 0;
+    journal->tid = 1;
+    journal->started_ns = 0;
+    journal->handle_running = 0;
+    journal->handle_dirty = 0;
+    journal->handle_credits = 0;
+    journal->handle_blocks = 0;
+    journal->batch = FS_JOURNAL_BATCH;
+    journal->interval_ms = FS_JOURNAL_COMMIT_INTERVAL_MS;
+    journal->pending_writes = 0;
+
+    for (i = 0; i < FS_JOURNAL_REASON_COUNT; i++)
+        journal->commit_count[i] = 0;
+    journal->handle_total = 0;
+    journal->block_total = 0;
+    journal->commit_ns = 0;
+    journal->replay_count = 0;
+    histogram_init(&journal->latency);
+
+    if (!clean && image->fd >= 0)
+        fs_journal_replay(image);
+}
+
+/**
+ * It starts an operation (handle) in the running
+ * transaction, which may dirty the specified amount
+ * of blocks besides those every operation may dirty
+ * (see FS_JOURNAL_SHARED_CREDITS). If the transaction
+ * may not hold them, then it is committed beforehand.
+ *
+ * @param image the file system image
+ * @param credits the amount of blocks
+ *
+ * @return 1 if the handle has been started; otherwise,
+ *         if no transaction may hold the blocks, 0 is
+ *         returned and the operation must be refused.
+ */
+int fs_journal_begin(fs_image_t* image, int credits) {
+    fs_journal_t* journal = &image->journal;
+
+    credits += FS_JOURNAL_SHARED_CREDITS;
+    if (credits > FS_JOURNAL_CAPACITY)
+        return 0;
+
+    if (journal->block_count + credits > FS_JOURNAL_CAPACITY)
+        fs_journal_commit(image, FS_JOURNAL_REASON_FULL);
+
+    journal->handle_running = 1;
+    journal->handle_dirty = 0;
+    journal->handle_credits = credits;
+    journal->handle_blocks = 0;
+
+    return 1;
+}
+
+/**
+ * It adds the metadata block holding the specified
+ * address of the mapping to the running transaction.
+ * It is supposed to be invoked before the block is
+ * modified. If the running handle has run out of its
+ * credits, then the application is exited.
+ *
+ * @param image the file system image
+ * @param address an address within the block
+ */
+void fs_journal_dirty(fs_image_t* image, const void* address) {
+    fs_journal_t* journal = &image->journal;
+    const int block = (int) (((const char *) address - image->base) / FS_BLOCK_SIZE);
+
+    journal->handle_dirty = 1;
+    if (FS_JOURNAL_TEST(journal->dirty, block))
+        return;
+
+    /* A block dirtied out of any handle (e.g., by the format) */
+    /* gets a transaction of its own if the running one is full */
+    if (!journal->handle_running && journal->block_count == FS_JOURNAL_CAPACITY)
+        fs_journal_commit(image, FS_JOURNAL_REASON_FULL);
+
+    /* It checks if the handle dirties more blocks than it has */
+    /* reserved, hence the transaction could be overflown */
+    if (journal->handle_running && journal->handle_blocks++ == journal->handle_credits) {
+        printf("The journal handle has dirtied more than its %d blocks.\n", journal->handle_credits);
+        exit(EXIT_FAILURE);
+    }
+
+    /* The transaction starts once its first block is dirtied */
+    if (journal->block_count == 0)
+        journal->started_ns = fs_journal_now_ns();
+
+    FS_JOURNAL_SET(journal->dirty, block);
+    journal->blocks[journal->block_count++] = block;
+}
+
+/**
+ * It ends the running operation (handle), and it
+ * commits the transaction if it has gathered enough
+ * handles or it has stayed open for too long.
+ *
+ * @param image the file system image
+ */
+void fs_journal_end(fs_image_t* image) {
+    fs_journal_t* journal = &image->journal;
+
+    if (journal->handle_dirty)
+        journal->handle_count++;
+    journal->handle_running = 0;
+    journal->handle_dirty = 0;
+
+    if (journal->handle_count >= journal->batch)
+        fs_journal_commit(image, FS_JOURNAL_REASON_BATCH);
+    else fs_journal_poll(image);
+}
+
+/**
+ * It commits the running transaction if it has
+ * stayed open for too long.
+ *
+ * @param image the file system image
+ *
+ * @return 1 if the transaction has been committed;
+ *         otherwise, 0 is returned.
+ */
+int fs_journal_poll(fs_image_t* image) {
+    fs_journal_t* journal = &image->journal;
+
+    if (journal->block_count == 0 || journal->handle_running
+        || fs_journal_now_ns() - journal->started_ns < journal->interval_ms * 1000000L)
+        return 0;
+
+    return fs_journal_commit(image, FS_JOURNAL_REASON_INTERVAL);
+}
+
+/**
+ * It commits the running transaction, that is, it writes
+ * its blocks to the journal area, it seals it and it writes
+ * the blocks back to their home location afterwards.
+ *
+ * @param image the file system image
+ * @param reason the reason of the commit
+ *
+ * @return 1 if there was something to be committed;
+ *         otherwise, 0 is returned.
+ */
+int fs_journal_commit(fs_image_t* image, fs_journal_reason_t reason) {
+    fs_journal_t* journal = &image->journal;
+    char* area = image->base + (size_t) FS_JOURNAL_START * FS_BLOCK_SIZE;
+    fs_journal_header_t* descriptor = (fs_journal_header_t *) area;
+    fs_journal_header_t* commit;
+    const long start = fs_journal_now_ns();
+    register int i;
+    long end;
+
+    if (journal->block_count == 0)
+        return 0;
+
+    /* The blocks are copied right after the descriptor block */
+    for (i = 0; i < journal->block_count; i++)
+        memcpy(area + (size_t) (i + 1) * FS_BLOCK_SIZE,
+               image->base + (size_t) journal->blocks[i] * FS_BLOCK_SIZE, FS_BLOCK_SIZE);
+
+    memset(descriptor, 0, FS_BLOCK_SIZE);
+    descriptor->magic = FS_JOURNAL_MAGIC;
+    descriptor->commit = 0;
+    descriptor->tid = journal->tid;
+    descriptor->count = journal->block_count;
+    descriptor->checksum = fs_journal_checksum(area + FS_BLOCK_SIZE, journal->block_count);
+    memcpy(descriptor->blocks, journal->blocks, sizeof(int) * journal->block_count);
+
+    commit = (fs_journal_header_t *)(area + (size_t) (journal->block_count + 1) * FS_BLOCK_SIZE);
+    memcpy(commit, descriptor, sizeof(fs_journal_header_t));
+    commit->commit = 1;
+
+    /* The transaction is durable once the journal is flushed, */
+    /* hence its blocks may be written back home afterwards */
+    fs_image_write_back(image, FS_JOURNAL_START, journal->block_count + 2, 1);
+    for (i = 0; i < journal->block_count; i++)
+        fs_image_write_back(image, journal->blocks[i], 1, i == journal->block_count - 1);
+    memset(journal->dirty, 0, sizeof(journal->dirty));
+
+    end = fs_journal_now_ns();
+    histogram_record(&journal->latency, (end - journal->started_ns) / 1000);
+    journal->commit_ns += end - start;
+    journal->commit_count[reason]++;
+    journal->handle_total += journal->handle_count;
+    journal->block_total += journal->block_count;
+
+    /* The journal write is also issued to the simulated disk (see FS_JOURNAL_TRACK) */
+    journal->pending_writes++;
+
+    journal->tid++;
+    journal->block_count = 0;
+    journal->handle_count = 0;
+
+    return 1;
+}
+
+/**
+ * It prints the journal statistics, that is, its
+ * overhead against its commit latency on the host.
+ *
+ * @param journal the journal
+ * @param fp the file to be printed to
+ */
+void fs_journal_report(fs_journal_t* journal, FILE* fp) {
+    const long commits = journal->commit_count[FS_JOURNAL_REASON_BATCH] + journal->commit_count[FS_JOURNAL_REASON_INTERVAL]
+                         + journal->commit_count[FS_JOURNAL_REASON_FULL] + journal->commit_count[FS_JOURNAL_REASON_FORCED];
+
+    /* The commits are done by the kernel on the host, and no */
+    /* process waits for them, hence their latency is host time */
+    fprintf(fp, "Journal (batch %d, interval %d ms): %ld commits (%ld batch, %ld interval, %ld full, "
+                "%ld forced), %.1lf handles/commit, %.1lf blocks/handle, mean host commit %.1lf us, "
+                "%ld replayed\n",
+            journal->batch, journal->interval_ms, commits,
+            journal->commit_count[FS_JOURNAL_REASON_BATCH], journal->commit_count[FS_JOURNAL_REASON_INTERVAL],
+            journal->commit_count[FS_JOURNAL_REASON_FULL], journal->commit_count[FS_JOURNAL_REASON_FORCED],
+            commits > 0 ? (double) journal->handle_total / commits : 0.0,
+            journal->handle_total > 0 ? (double) (journal->block_total + 2 * commits) / journal->handle_total : 0.0,
+            commits > 0 ? journal->commit_ns / 1000.0 / commits : 0.0, journal->replay_count);
+
+    fprintf(fp, "%-14s %8s %10s %8s %8s %8s %8s %8s\n",
+            "Host (us)", "Count", "Mean", "P50", "P90", "P99", "P99.9", "Max");
+    histogram_print(&journal->latency, "Commit", fp);
+}
+
+/* Internal File System Journal Function Definitions */
+
+/**
+ * It returns the current time in nanoseconds.
+ */
+static long fs_journal_now_ns() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/**
+ * It returns the checksum (FNV-1a) of the
+ * specified amount of blocks.
+ *
+ * @param blocks the blocks
+ * @param count the amount of blocks
+ */
+static unsigned int fs_journal_checksum(const char* blocks, int count) {
+    const size_t size = (size_t) count * FS_BLOCK_SIZE;
+    unsigned int hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+        hash = (hash ^ (unsigned char) blocks[i]) * 16777619u;
+
+    return hash;
+}
+
+/**
+ * It replays the last transaction of the journal onto
+ * the home blocks of the image, provided that it has
+ * been sealed by its commit block.
+ *
+ * @param image the file system image
+ */
+static void fs_journal_replay(fs_image_t* image) {
+    const off_t area = (off_t) FS_JOURNAL_START * FS_BLOCK_SIZE;
+    fs_journal_header_t descriptor;
+    fs_journal_header_t commit;
+    char* copies;
+    register int i;
+
+    /* It checks if there is no transaction or it is torn, */
+    /* that is, its commit block has not been written */
+    if (pread(image->fd, &descriptor, sizeof(descriptor), area) != sizeof(descriptor)
+        || descriptor.magic != FS_JOURNAL_MAGIC || descriptor.commit
+        || descriptor.count <= 0 || descriptor.count > FS_JOURNAL_CAPACITY
+        || pread(image->fd, &commit, sizeof(commit), area + (off_t) (descriptor.count + 1) * FS_BLOCK_SIZE) != sizeof(commit)
+        || commit.magic != FS_JOURNAL_MAGIC || !commit.commit || commit.tid != descriptor.tid)
+        return;
+
+    if (!(copies = (char *)malloc((size_t) descriptor.count * FS_BLOCK_SIZE))) {
+        printf("Not enough memory to replay the journal.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (pread(image->fd, copies, (size_t) descriptor.count * FS_BLOCK_SIZE, area + FS_BLOCK_SIZE)
+            == (ssize_t) descriptor.count * FS_BLOCK_SIZE
+        && fs_journal_checksum(copies, descriptor.count) == descriptor.checksum) {
+        for (i = 0; i < descriptor.count; i++)
+            if (pwrite(image->fd, copies + (size_t) i * FS_BLOCK_SIZE, FS_BLOCK_SIZE,
+                       (off_t) descriptor.blocks[i] * FS_BLOCK_SIZE) != FS_BLOCK_SIZE) {
+                printf("The journal of %s could not be replayed.\n", FS_IMAGE_PATH);
+                exit(EXIT_FAILURE);
+            }
+
+        fdatasync(image->fd);
+        image->journal.replay_count++;
+    }
+
+    free(copies);
+}
@@ -0,0 +1,245 @@
+#ifndef OS_PROJECT_JOURNAL_H
+#define OS_PROJECT_JOURNAL_H
+
+#include <stdio.h>
+
+#include "../tools/histogram.h"
+
+/**
+ * It represents the file system image (see fs_image.h).
+ */
+typedef struct FileSystemImage fs_image_t;
+
+/**
+ * It represents the amount of operations (handles) a
+ * transaction gathers before it is committed, and the
+ * time (ms) a transaction may stay open before it is
+ * committed, whichever comes first.
+ */
+#define FS_JOURNAL_BATCH (16)
+#define FS_JOURNAL_COMMIT_INTERVAL_MS (50)
+
+/**
+ * It represents the maximum amount of metadata blocks
+ * a transaction may hold, that is, the journal area
+ * but its descriptor and commit blocks.
+ */
+#define FS_JOURNAL_CAPACITY (FS_JOURNAL_BLOCKS - 2)
+
+/**
+ * It represents the amount of metadata blocks (credits)
+ * an operation may dirty at most. Every operation may
+ * dirty the superblock and both bitmaps, besides the
+ * inode table block of an allocated inode, the inode
+ * table block and the last and a new extent leaf of a
+ * grown file, and all of them plus the directory block
+ * of a name created in a grown directory.
+ */
+#define FS_JOURNAL_SHARED_CREDITS (3)
+#define FS_JOURNAL_INODE_CREDITS (1)
+#define FS_JOURNAL_GROW_CREDITS (3)
+#define FS_JOURNAL_CREATE_CREDITS (FS_JOURNAL_INODE_CREDITS + FS_JOURNAL_GROW_CREDITS + 1)
+
+/**
+ * It represents the disk track the journal lies on,
+ * that is, the middle one such that it is reached by
+ * the shortest seeks on average. The journal writes
+ * are told apart from those of the file of the track
+ * (see volume_journal_request).
+ */
+#define FS_JOURNAL_TRACK (DISK_TRACK_LIMIT / 2)
+
+/**
+ * It identifies a journal block.
+ */
+#define FS_JOURNAL_MAGIC (0x4A524E4C)
+
+/**
+ * It represents why a transaction has been
+ * committed, that is, it gathered enough
+ * operations, it stayed open for too long,
+ * it ran out of room or it was forced (e.g.,
+ * by a sync or by the unmount).
+ */
+typedef enum FileSystemJournalReason {
+    FS_JOURNAL_REASON_BATCH,
+    FS_JOURNAL_REASON_INTERVAL,
+    FS_JOURNAL_REASON_FULL,
+    FS_JOURNAL_REASON_FORCED,
+    FS_JOURNAL_REASON_COUNT
+} fs_journal_reason_t;
+
+/**
+ * It represents the descriptor block of a transaction,
+ * which lists the home blocks of the copies following
+ * it, and its commit block, which seals it.
+ */
+typedef struct FileSystemJournalHeader {
+    unsigned int magic;
+    int commit;
+    long tid;
+    int count;
+    unsigned int checksum;
+    int blocks[FS_JOURNAL_CAPACITY];
+} fs_journal_header_t;
+
+/**
+ * A write-ahead journal of the file system metadata. Every
+ * operation (handle) joins the running transaction with the
+ * metadata blocks it dirties, and the transaction is written
+ * to the journal area at once (group commit) before its blocks
+ * are written back to their home location (checkpoint). The
+ * last transaction is replayed if the image has not been
+ * unmounted cleanly.
+ */
+typedef struct FileSystemJournal {
+    /**
+     * It holds the dirty metadata blocks of the running
+     * transaction, a bitmap telling them apart, and the
+     * amount of handles that have dirtied some of them.
+     */
+    int blocks[FS_JOURNAL_CAPACITY];
+    int block_count;
+    unsigned char dirty[(FS_BLOCK_COUNT + 7) / 8];
+    int handle_count;
+
+    /**
+     * It holds the id of the running transaction and
+     * the time (ns) its first handle has joined it.
+     */
+    long tid;
+    long started_ns;
+
+    /**
+     * It is set while a handle is running and
+     * once it has dirtied some metadata block,
+     * and it holds the amount of blocks it may
+     * add to the transaction and has added.
+     */
+    int handle_running;
+    int handle_dirty;
+    int handle_credits;
+    int handle_blocks;
+
+    /**
+     * It holds the amount of handles a transaction
+     * gathers and the time (ms) it may stay open
+     * (see FS_JOURNAL_BATCH).
+     */
+    int batch;
+    int interval_ms;
+
+    /**
+     * It holds the amount of commits whose journal
+     * write has not been submitted to the disk yet.
+     */
+    int pending_writes;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of commits for each reason,
+     * the amount of handles and of blocks committed,
+     * the time (ns) spent committing on the host and
+     * the amount of transactions replayed on mount.
+     */
+    long commit_count[FS_JOURNAL_REASON_COUNT];
+    long handle_total;
+    long block_total;
+    long commit_ns;
+    long replay_count;
+
+    /**
+     * It holds the commit latency (us), that is, the
+     * host time from the first handle of a transaction
+     * until the transaction is durable in the host file,
+     * which does not include the simulated journal write.
+     */
+    histogram_t latency;
+} fs_journal_t;
+
+/* File System Journal Function Prototypes */
+
+/**
+ * It initializes the journal and, if the image has
+ * not been unmounted cleanly, it replays its last
+ * transaction onto the home blocks. It is supposed
+ * to be invoked before the image is mapped.
+ *
+ * @param image the file system image
+ * @param clean if it is 0, the image has not been
+ *              unmounted cleanly
+ */
+void fs_journal_init(fs_image_t* image, int clean);
+
+/**
+ * It starts an operation (handle) in the running
+ * transaction, which may dirty the specified amount
+ * of blocks besides those every operation may dirty
+ * (see FS_JOURNAL_SHARED_CREDITS). If the transaction
+ * may not hold them, then it is committed beforehand.
+ *
+ * @param image the file system image
+ * @param credits the amount of blocks
+ *
+ * @return 1 if the handle has been started; otherwise,
+ *         if no transaction may hold the blocks, 0 is
+ *         returned and the operation must be refused.
+ */
+int fs_journal_begin(fs_image_t* image, int credits);
+
+/**
+ * It adds the metadata block holding the specified
+ * address of the mapping to the running transaction.
+ * It is supposed to be invoked before the block is
+ * modified. If the running handle has run out of its
+ * credits, then the application is exited.
+ *
+ * @param image the file system image
+ * @param address an address within the block
+ */
+void fs_journal_dirty(fs_image_t* image, const void* address);
+
+/**
+ * It ends the running operation (handle), and it
+ * commits the transaction if it has gathered enough
+ * handles or it has stayed open for too long.
+ *
+ * @param image the file system image
+ */
+void fs_journal_end(fs_image_t* image);
+
+/**
+ * It commits the running transaction if it has
+ * stayed open for too long.
+ *
+ * @param image the file system image
+ *
+ * @return 1 if the transaction has been committed;
+ *         otherwise, 0 is returned.
+ */
+int fs_journal_poll(fs_image_t* image);
+
+/**
+ * It commits the running transaction, that is, it writes
+ * its blocks to the journal area, it seals it and it writes
+ * the blocks back to their home location afterwards.
+ *
+ * @param image the file system image
+ * @param reason the reason of the commit
+ *
+ * @return 1 if there was something to be committed;
+ *         otherwise, 0 is returned.
+ */
+int fs_journal_commit(fs_image_t* image, fs_journal_reason_t reason);
+
+/**
+ * It prints the journal statistics, that is, its
+ * overhead against its commit latency on the host.
+ *
+ * @param journal the journal
+ * @param fp the file to be printed to
+ */
+void fs_journal_report(fs_journal_t* journal, FILE* fp);
+
+#endif // OS_PROJECT_JOURNAL_H
@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <stdio.h>
 
 #include "../tools/constants.h"
@@ -36,6 +37,13 @@ static void sleep();
  */
 static void wakeup(process_t* proc);
 
+/**
+ * It issues the journal writes of the transactions
+ * committed so far to the disk, such that the journal
+ * traffic competes with the other disk requests.
+ */
+static void journal_submit();
+
 /* Kernel Function Definitions */
 
 /**
@@ -61,8 +69,11 @@ void kernel_init() {
     scheduler_init(&kernel->scheduler);
     LOG_KERNEL("Scheduler initialized.\n");
 
-    disk_scheduler_init(&kernel->disk_scheduler);
-    LOG_KERNEL("Disk Scheduler initialized.\n");
+    volume_init(&kernel->volume, VOLUME_BACKEND, VOLUME_LAYOUT);
+    LOG_KERNEL("Disk volume initialized.\n");
+
+    buffer_cache_init(&kernel->buffer_cache, BUFFER_CACHE_CAPACITY);
+    LOG_KERNEL("Buffer cache initialized.\n");
 
     semaphore_table_init(&kernel->sem_table);
     LOG_KERNEL("Semaphore table initialized.\n");
@@ -114,11 +125,23 @@ void sysCall(kernel_function_t func, void *arg) {
             const int track = (int)arg;
             process_t* curr_proc = kernel->scheduler.scheduled_proc;
 
-            /* It schedules a next process and put the current one into the blocked queue */
-            schedule_process(&kernel->scheduler, IO_REQUESTED);
+            /* It reads the following tracks ahead if the process reads sequentially */
+            disk_read_ahead(curr_proc, &kernel->volume, track);
+
+            /* It checks if the block is in the buffer cache, hence the read */
+            /* completes right away without blocking the process */
+            if (buffer_cache_read(&kernel->buffer_cache, DISK_BLOCK(track)))
+                curr_proc->remaining -= BUFFER_CACHE_HIT_TIME;
+            else {
+                /* It schedules a next process and put the current one into the blocked queue */
+                schedule_process(&kernel->scheduler, IO_REQUESTED);
+
+                /* It requests a disk read operation for the specified track */
+                volume_request(curr_proc, &kernel->volume, track, 1, 0, DISK_PRODUCER_KERNEL);
+            }
 
-            /* It requests a disk read operation for the specified track */
-            disk_request(curr_proc, &kernel->disk_scheduler, track, 1);
+            /* Every request made by the system call is submitted at once */
+            volume_submit(&kernel->volume, DISK_PRODUCER_KERNEL);
 
             fs_op_request_t fs_req;
             fs_req.proc = curr_proc;
@@ -134,11 +157,20 @@ void sysCall(kernel_function_t func, void *arg) {
             const int track = (int)arg;
             process_t* curr_proc = kernel->scheduler.scheduled_proc;
 
-            /* It schedules a next process and put the current one into the blocked queue */
-            schedule_process(&kernel->scheduler, IO_REQUESTED);
+            /* It checks if the write has landed in a dirty buffer, hence */
+            /* it is written back later without blocking the process */
+            if (buffer_cache_write(&kernel->buffer_cache, DISK_BLOCK(track)))
+                curr_proc->remaining -= BUFFER_CACHE_HIT_TIME;
+            else {
+                /* It schedules a next process and put the current one into the blocked queue */
+                schedule_process(&kernel->scheduler, IO_REQUESTED);
 
-            /* It requests a disk write operation for the specified track */
-            disk_request(curr_proc, &kernel->disk_scheduler, track, 0);
+                /* It requests a disk write operation for the specified track */
+                volume_request(curr_proc, &kernel->volume, track, 0, 0, DISK_PRODUCER_KERNEL);
+            }
+
+            /* Every request made by the system call is submitted at once */
+            volume_submit(&kernel->volume, DISK_PRODUCER_KERNEL);
 
             fs_op_request_t fs_req;
             fs_req.proc = curr_proc;
@@ -150,6 +182,66 @@ void sysCall(kernel_function_t func, void *arg) {
             sysCall(FS_REQUEST, (void *)(&fs_req));
             break;
         }
+        case DISK_SYNC_REQUEST: {
+            process_t* curr_proc = kernel->scheduler.scheduled_proc;
+
+            /* The metadata made so far is made durable right away */
+            sysCall(FS_JOURNAL_COMMIT, (void *) 1);
+
+            /* It checks if there is no dirty buffer, hence nothing is waited */
+            if (buffer_cache_dirty(&kernel->buffer_cache) == 0)
+                break;
+
+            /* It schedules a next process and put the current one into the blocked queue */
+            schedule_process(&kernel->scheduler, IO_REQUESTED);
+
+            /* It checks if the dirty buffers have been flushed meanwhile */
+            if (!buffer_cache_sync(&kernel->buffer_cache, curr_proc))
+                interruptControl(DISK_FINISH, curr_proc);
+            break;
+        }
+        case DISK_AREAD_REQUEST: {
+            const int track = (int)(intptr_t)arg;
+            process_t* curr_proc = kernel->scheduler.scheduled_proc;
+
+            /* It reads the following tracks ahead if the process reads sequentially */
+            disk_read_ahead(curr_proc, &kernel->volume, track);
+
+            /* It checks if the block is in the buffer cache, otherwise the */
+            /* read is issued and the process keeps running meanwhile */
+            if (buffer_cache_read(&kernel->buffer_cache, DISK_BLOCK(track)))
+                curr_proc->remaining -= BUFFER_CACHE_HIT_TIME;
+            else {
+                curr_proc->aio_pending++;
+                volume_request(curr_proc, &kernel->volume, track, 1, 1, DISK_PRODUCER_KERNEL);
+            }
+
+            /* Every request made by the system call is submitted at once */
+            volume_submit(&kernel->volume, DISK_PRODUCER_KERNEL);
+
+            fs_op_request_t fs_req;
+            fs_req.proc = curr_proc;
+            fs_req.track = track;
+            fs_req.read = 1;
+
+            /* It requests a file system request for handling the file */
+            /* that is being read at the specified track in the disk */
+            sysCall(FS_REQUEST, (void *)(&fs_req));
+            break;
+        }
+        case DISK_AWAIT_REQUEST: {
+            process_t* curr_proc = kernel->scheduler.scheduled_proc;
+
+            /* It checks if every asynchronous read has completed, hence nothing is waited */
+            if (curr_proc->aio_pending == 0)
+                break;
+
+            /* It schedules a next process and put the current one into the blocked queue */
+            /* until its last asynchronous read completes (see DISK_AIO_FINISH) */
+            curr_proc->aio_waiting = 1;
+            schedule_process(&kernel->scheduler, IO_REQUESTED);
+            break;
+        }
         case PRINT_REQUEST: {
             process_t* curr_proc = kernel->scheduler.scheduled_proc;
 
@@ -165,6 +257,30 @@ void sysCall(kernel_function_t func, void *arg) {
             if (fs_req->read)
                 fs_read_request(&kernel->file_table, fs_req->proc, DISK_BLOCK(fs_req->track));
             else fs_write_request(&kernel->file_table, fs_req->proc, DISK_BLOCK(fs_req->track));
+            journal_submit();
+            break;
+        }
+        case FS_OPEN_REQUEST: {
+            instr_t* instr = (instr_t *)arg;
+
+            fs_open_path_request(&kernel->file_table, kernel->scheduler.scheduled_proc,
+                                 instr->path, instr->op == CREAT);
+            journal_submit();
+            break;
+        }
+        case FS_JOURNAL_COMMIT: {
+            /* The running transaction is committed right away if it is */
+            /* forced, along with the delayed blocks of every file; */
+            /* otherwise, only once it has stayed open too long */
+            if (arg) {
+                fs_image_flush_all(&kernel->file_table.image);
+                fs_journal_commit(&kernel->file_table.image, FS_JOURNAL_REASON_FORCED);
+            } else fs_journal_poll(&kernel->file_table.image);
+            journal_submit();
+            break;
+        }
+        case FS_CLOSE_REQUEST: {
+            fs_close_fd_request(&kernel->file_table, kernel->scheduler.scheduled_proc, (int)(intptr_t)arg);
             break;
         }
     }
@@ -198,6 +314,20 @@ void interruptControl(kernel_function_t func, void *arg) {
             schedule_unblock_process(&kernel->scheduler, (process_t *)arg, LOW_QUEUE);
             break;
         }
+        /* The process is only unblocked once its last asynchronous read */
+        /* completes, or it is finished if it has run out of instructions */
+        case DISK_AIO_FINISH: {
+            process_t* proc = (process_t *)arg;
+
+            if (--proc->aio_pending > 0 || !proc->aio_waiting)
+                break;
+
+            proc->aio_waiting = 0;
+            if (proc->pc >= proc->code_len)
+                sysCall(PROCESS_FINISH, proc);
+            else schedule_unblock_process(&kernel->scheduler, proc, LOW_QUEUE);
+            break;
+        }
         /* When the process comes back from an I/O request it is put at the low queue */
         case PRINT_FINISH: {
             schedule_unblock_process(&kernel->scheduler, (process_t *)arg, LOW_QUEUE);
@@ -253,6 +383,37 @@ void eval(process_t* proc, instr_t* instr) {
         sysCall(DISK_WRITE_REQUEST, instr->value);
         break;
     }
+    case SYNC: {
+        LOG_KERNEL_EVAL_A("Process %s has requested its writes to be flushed.\n", proc->name);
+
+        sysCall(DISK_SYNC_REQUEST, NULL);
+        break;
+    }
+    case AREAD: {
+        LOG_KERNEL_EVAL_A("Process %s has issued an asynchronous read at track %d.\n", proc->name, instr->value);
+
+        sysCall(DISK_AREAD_REQUEST, (void *)(intptr_t)instr->value);
+        break;
+    }
+    case AWAIT: {
+        LOG_KERNEL_EVAL_A("Process %s waits for its asynchronous reads.\n", proc->name);
+
+        sysCall(DISK_AWAIT_REQUEST, NULL);
+        break;
+    }
+    case OPEN:
+    case CREAT: {
+        LOG_KERNEL_EVAL_A("Process %s has requested to open %s.\n", proc->name, instr->path);
+
+        sysCall(FS_OPEN_REQUEST, instr);
+        break;
+    }
+    case CLOSE: {
+        LOG_KERNEL_EVAL_A("Process %s has requested to close the descriptor %d.\n", proc->name, instr->value);
+
+        sysCall(FS_CLOSE_REQUEST, (void *)(intptr_t)instr->value);
+        break;
+    }
     case PRINT: {
         LOG_KERNEL_EVAL_A("Process %s has requested a print operation for %d u.t.\n", proc->name, instr->value);
 
@@ -283,3 +444,20 @@ static void sleep() {
 static void wakeup(process_t* proc) {
     schedule_unblock_process(&kernel->scheduler, proc, HIGH_QUEUE);
 }
+
+/**
+ * It issues the journal writes of the transactions
+ * committed so far to the disk, such that the journal
+ * traffic competes with the other disk requests.
+ */
+static void journal_submit() {
+    fs_journal_t* journal = &kernel->file_table.image.journal;
+
+    if (journal->pending_writes == 0)
+        return;
+
+    for (; journal->pending_writes > 0; journal->pending_writes--)
+        volume_journal_request(&kernel->volume, FS_JOURNAL_TRACK, DISK_PRODUCER_KERNEL);
+
+    volume_submit(&kernel->volume, DISK_PRODUCER_KERNEL);
+}
@@ -5,6 +5,8 @@
 #include "../sched/sched.h"
 #include "../process/instruction.h"
 #include "../disk/disk.h"
+#include "../disk/volume.h"
+#include "../disk/buffer.h"
 #include "../io/print.h"
 #include "../file/file.h"
 
@@ -17,7 +19,11 @@ typedef enum KernelFunction {
     /* DiskScheduler Related Functions */
     DISK_READ_REQUEST = 4,
     DISK_WRITE_REQUEST = 16,
+    DISK_SYNC_REQUEST = 17,
+    DISK_AREAD_REQUEST = 18,
+    DISK_AWAIT_REQUEST = 19,
     DISK_FINISH = 5,
+    DISK_AIO_FINISH = 20,
 
     /* Memory Related Functions */
     MEM_LOAD_REQ = 6,
@@ -26,6 +32,9 @@ typedef enum KernelFunction {
     /* File System Related Functions */
     FS_REQUEST = 8,
     FS_FINISH = 9,
+    FS_OPEN_REQUEST = 21,
+    FS_CLOSE_REQUEST = 22,
+    FS_JOURNAL_COMMIT = 23,
 
     /* Resource Acquisition Related Functions */
     SEMAPHORE_P = 10,
@@ -47,8 +56,11 @@ typedef struct Kernel {
     /* Scheduler Information */
     scheduler_t scheduler;
 
-    /* Disk Scheduler Information */
-    disk_scheduler_t disk_scheduler;
+    /* Disk Volume Information */
+    volume_t volume;
+
+    /* Buffer Cache Information */
+    buffer_cache_t buffer_cache;
 
     /* Semaphore Table Information */
     semaphore_table_t sem_table;
@@ -1,5 +1,7 @@
 #include <time.h>
 
+#include "tools/slab.h"
+
 #ifndef OS_CPU_LOADED
 #define OS_CPU_LOADED
 #include "cpu/cpu.h"
@@ -18,6 +20,20 @@ int main() {
     cpu_init();
 
     begin_terminal();
+
+    /* No system call may touch the file system while it is reported and unmounted */
+    cpu_halt();
+
+    /* It reports the paging, the disk scheduling, the file system and the kernel object allocation counters */
+    segment_table_report(&kernel->seg_table, stdout);
+    volume_report(&kernel->volume, stdout);
+    buffer_cache_report(&kernel->buffer_cache, stdout);
+    fs_image_report(&kernel->file_table.image, stdout);
+    dcache_report(&kernel->file_table.dcache, stdout);
+    slab_report(stdout);
+
+    fs_image_unmount(&kernel->file_table.image);
+    fs_journal_report(&kernel->file_table.image.journal, stdout);
     return 0;
 }
 
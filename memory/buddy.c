@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "buddy.h"
+
+/* Buddy Internal Function Definitions */
+
+/**
+ * It returns the order (relative to the smallest
+ * block) of the block that fits the specified size.
+ *
+ * @param size the size in bytes
+ *
+ * @return the block order
+ */
+static int order_of(int size) {
+    int order = 0;
+
+    while (BUDDY_BLOCK_SIZE(order) < size && order < BUDDY_ORDER_COUNT - 1)
+        order++;
+
+    return order;
+}
+
+/**
+ * It pushes the specified block into the
+ * free list of the specified order.
+ *
+ * @param buddy the buddy allocator
+ * @param idx the block number
+ * @param order the block order
+ */
+static void free_list_push(buddy_t* buddy, int idx, int order) {
+    buddy->order[idx] = order;
+    buddy->is_free[idx] = 1;
+    buddy->prev[idx] = -1;
+    buddy->next[idx] = buddy->free_head[order];
+
+    if (buddy->free_head[order] != -1)
+        buddy->prev[buddy->free_head[order]] = idx;
+
+    buddy->free_head[order] = idx;
+    buddy->free_count[order]++;
+}
+
+/**
+ * It removes the specified block from the
+ * free list of the specified order.
+ *
+ * @param buddy the buddy allocator
+ * @param idx the block number
+ * @param order the block order
+ */
+static void free_list_remove(buddy_t* buddy, int idx, int order) {
+    if (buddy->prev[idx] != -1)
+        buddy->next[buddy->prev[idx]] = buddy->next[idx];
+    else buddy->free_head[order] = buddy->next[idx];
+
+    if (buddy->next[idx] != -1)
+        buddy->prev[buddy->next[idx]] = buddy->prev[idx];
+
+    buddy->is_free[idx] = 0;
+    buddy->free_count[order]--;
+}
+
+/* Buddy Allocator Function Definitions */
+
+/**
+ * It initializes the buddy allocator managing the
+ * specified amount of memory. The memory size must
+ * be a power of two between the smallest and the
+ * largest block sizes.
+ *
+ * @param buddy the buddy allocator
+ * @param size the memory size in bytes
+ */
+void buddy_init(buddy_t* buddy, int size) {
+    register int i;
+
+    buddy->size = size;
+    buddy->max_order = order_of(size);
+    buddy->block_count = size >> BUDDY_MIN_ORDER;
+
+    buddy->order = (unsigned char *)malloc(sizeof(unsigned char) * buddy->block_count);
+    buddy->is_free = (unsigned char *)malloc(sizeof(unsigned char) * buddy->block_count);
+    buddy->is_allocated = (unsigned char *)malloc(sizeof(unsigned char) * buddy->block_count);
+    buddy->requested = (int *)malloc(sizeof(int) * buddy->block_count);
+    buddy->next = (int *)malloc(sizeof(int) * buddy->block_count);
+    buddy->prev = (int *)malloc(sizeof(int) * buddy->block_count);
+
+    /* It checks if the block information could not be allocated */
+    if (!buddy->order || !buddy->is_free || !buddy->is_allocated || !buddy->requested
+        || !buddy->next || !buddy->prev) {
+        printf("Not enough memory to allocate the buddy allocator.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    buddy->alloc_count = 0;
+    buddy->failed_count = 0;
+    buddy->alloc_ns_total = 0;
+    buddy->alloc_ns_max = 0;
+
+    for (i = 0; i < BUDDY_ORDER_COUNT; i++)
+        buddy->alloc_order_count[i] = 0;
+
+    buddy_reset(buddy);
+}
+
+/**
+ * It releases every block, such that the whole
+ * memory becomes a single free block. Statistics
+ * about past allocations are kept.
+ *
+ * @param buddy the buddy allocator
+ */
+void buddy_reset(buddy_t* buddy) {
+    register int i;
+
+    for (i = 0; i < BUDDY_ORDER_COUNT; i++) {
+        buddy->free_head[i] = -1;
+        buddy->free_count[i] = 0;
+    }
+
+    for (i = 0; i < buddy->block_count; i++) {
+        buddy->is_free[i] = 0;
+        buddy->is_allocated[i] = 0;
+        buddy->requested[i] = 0;
+    }
+
+    free_list_push(buddy, 0, buddy->max_order);
+
+    buddy->free_bytes = buddy->size;
+    buddy->allocated_bytes = 0;
+    buddy->requested_bytes = 0;
+}
+
+/**
+ * It allocates a block big enough to hold the
+ * requested amount of memory.
+ *
+ * @param buddy the buddy allocator
+ * @param size the requested size in bytes
+ *
+ * @return the block address or -1 if there is
+ *         no free block big enough.
+ */
+int buddy_alloc(buddy_t* buddy, int size) {
+    struct timespec start;
+    struct timespec end;
+    const int order = order_of(size);
+    int curr;
+    int idx;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /* It looks for the smallest free block that fits the request */
+    for (curr = order; curr <= buddy->max_order; curr++)
+        if (buddy->free_head[curr] != -1)
+            break;
+
+    if (size > buddy->size || curr > buddy->max_order) {
+        buddy->failed_count++;
+        return -1;
+    }
+
+    idx = buddy->free_head[curr];
+    free_list_remove(buddy, idx, curr);
+
+    /* It splits the block until it has the requested order, */
+    /* such that the upper halves become free buddies */
+    while (curr > order) {
+        curr--;
+        free_list_push(buddy, idx + (1 << curr), curr);
+    }
+
+    buddy->order[idx] = order;
+    buddy->is_allocated[idx] = 1;
+    buddy->requested[idx] = size;
+
+    buddy->free_bytes -= BUDDY_BLOCK_SIZE(order);
+    buddy->allocated_bytes += BUDDY_BLOCK_SIZE(order);
+    buddy->requested_bytes += size;
+    buddy->alloc_count++;
+    buddy->alloc_order_count[order]++;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    const long elapsed = (end.tv_sec - start.tv_sec) * 1000000000L
+                         + (end.tv_nsec - start.tv_nsec);
+
+    buddy->alloc_ns_total += elapsed;
+    if (elapsed > buddy->alloc_ns_max)
+        buddy->alloc_ns_max = elapsed;
+
+    return idx << BUDDY_MIN_ORDER;
+}
+
+/**
+ * It frees the block at the specified address,
+ * merging it with its buddies while they are free.
+ * If there is no block allocated at that address,
+ * then the application is exited.
+ *
+ * @param buddy the buddy allocator
+ * @param addr the block address
+ */
+void buddy_free(buddy_t* buddy, int addr) {
+    int idx = addr >> BUDDY_MIN_ORDER;
+    int order;
+    int buddy_idx;
+
+    /* It checks if the address is not the head of an allocated */
+    /* block, that is, it has been freed or never handed out */
+    if (addr < 0 || addr >= buddy->size || (addr & (BUDDY_BLOCK_SIZE(0) - 1))
+        || !buddy->is_allocated[idx]) {
+        printf("The memory block at %d has not been allocated.\n", addr);
+        exit(EXIT_FAILURE);
+    }
+
+    order = buddy->order[idx];
+    buddy->is_allocated[idx] = 0;
+
+    buddy->free_bytes += BUDDY_BLOCK_SIZE(order);
+    buddy->allocated_bytes -= BUDDY_BLOCK_SIZE(order);
+    buddy->requested_bytes -= buddy->requested[idx];
+    buddy->requested[idx] = 0;
+
+    /* It merges the block with its buddy while the buddy is free */
+    while (order < buddy->max_order) {
+        buddy_idx = idx ^ (1 << order);
+
+        if (!buddy->is_free[buddy_idx] || buddy->order[buddy_idx] != order)
+            break;
+
+        free_list_remove(buddy, buddy_idx, order);
+        idx = idx < buddy_idx ? idx : buddy_idx;
+        order++;
+    }
+
+    free_list_push(buddy, idx, order);
+}
+
+/**
+ * It returns the size of the block that would be
+ * handed out for the requested amount of memory.
+ *
+ * @param size the requested size in bytes
+ *
+ * @return the block size in bytes
+ */
+int buddy_block_size(int size) {
+    return BUDDY_BLOCK_SIZE(order_of(size));
+}
+
+/**
+ * It returns the size of the largest free block.
+ *
+ * @param buddy the buddy allocator
+ *
+ * @return the largest free block size in bytes
+ */
+int buddy_largest_free(const buddy_t* buddy) {
+    int order;
+
+    for (order = buddy->max_order; order >= 0; order--)
+        if (buddy->free_count[order] > 0)
+            return BUDDY_BLOCK_SIZE(order);
+
+    return 0;
+}
+
+/**
+ * It fills the specified structure with the
+ * current fragmentation information.
+ *
+ * @param buddy the buddy allocator
+ * @param stats the structure to be filled
+ */
+void buddy_stats(const buddy_t* buddy, buddy_stats_t* stats) {
+    stats->free_bytes = buddy->free_bytes;
+    stats->largest_free = buddy_largest_free(buddy);
+
+    stats->external_frag = buddy->free_bytes == 0 ? 0.0
+        : 1.0 - (double) stats->largest_free / buddy->free_bytes;
+    stats->internal_frag = buddy->allocated_bytes == 0 ? 0.0
+        : 1.0 - (double) buddy->requested_bytes / buddy->allocated_bytes;
+    stats->mean_alloc_ns = buddy->alloc_count == 0 ? 0.0
+        : (double) buddy->alloc_ns_total / buddy->alloc_count;
+}
@@ -0,0 +1,198 @@
+#ifndef OS_PROJECT_BUDDY_H
+#define OS_PROJECT_BUDDY_H
+
+/**
+ * It represents the smallest block order managed by
+ * the buddy allocator, that is, blocks of 4 Kbytes
+ * (the page size).
+ */
+#define BUDDY_MIN_ORDER (12)
+
+/**
+ * It represents the largest block order that may be
+ * managed by the buddy allocator, that is, blocks of
+ * 1 Gbyte (the maximum memory size).
+ */
+#define BUDDY_MAX_ORDER (30)
+
+#define BUDDY_ORDER_COUNT (BUDDY_MAX_ORDER - BUDDY_MIN_ORDER + 1)
+#define BUDDY_BLOCK_SIZE(order) (1 << ((order) + BUDDY_MIN_ORDER))
+
+typedef struct BuddyAllocator {
+    /**
+     * It holds the amount of memory
+     * managed by the allocator in bytes.
+     */
+    int size;
+
+    /**
+     * It holds the order (relative to the
+     * smallest block) of the largest block.
+     */
+    int max_order;
+
+    /**
+     * It holds the amount of smallest
+     * blocks the memory is made of.
+     */
+    int block_count;
+
+    /**
+     * Per smallest block information, indexed
+     * by the block number. The order and the free
+     * and allocated flags are only meaningful for
+     * the block heads, while next and prev link the
+     * free blocks of the same order in a free list.
+     */
+    unsigned char* order;
+    unsigned char* is_free;
+    unsigned char* is_allocated;
+    int* requested;
+    int* next;
+    int* prev;
+
+    /**
+     * It holds the head of the free list
+     * for each block order (-1 if empty).
+     */
+    int free_head[BUDDY_ORDER_COUNT];
+
+    /**
+     * It holds the amount of free
+     * blocks for each block order.
+     */
+    int free_count[BUDDY_ORDER_COUNT];
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of free memory,
+     * the amount of memory handed out in
+     * blocks and the amount of memory that
+     * has been actually requested (bytes).
+     */
+    int free_bytes;
+    int allocated_bytes;
+    int requested_bytes;
+
+    /**
+     * It holds the amount of allocations
+     * that have been made (per order as
+     * well) and that have failed.
+     */
+    long alloc_count;
+    long alloc_order_count[BUDDY_ORDER_COUNT];
+    long failed_count;
+
+    /**
+     * It holds the total and the maximum
+     * allocation latency measured in
+     * nanoseconds.
+     */
+    long alloc_ns_total;
+    long alloc_ns_max;
+} buddy_t;
+
+/**
+ * It represents a snapshot of the buddy
+ * allocator fragmentation information.
+ */
+typedef struct BuddyStats {
+    int free_bytes;
+    int largest_free;
+
+    /**
+     * It is the fraction of the free memory that
+     * can not be handed out as a single block, that
+     * is, 1 - largest free block / free memory.
+     */
+    double external_frag;
+
+    /**
+     * It is the fraction of the allocated memory
+     * that has been wasted by rounding the requests
+     * up to a power of two block size.
+     */
+    double internal_frag;
+
+    /**
+     * It is the mean allocation latency
+     * measured in nanoseconds.
+     */
+    double mean_alloc_ns;
+} buddy_stats_t;
+
+/* Buddy Allocator Function Prototypes */
+
+/**
+ * It initializes the buddy allocator managing the
+ * specified amount of memory. The memory size must
+ * be a power of two between the smallest and the
+ * largest block sizes.
+ *
+ * @param buddy the buddy allocator
+ * @param size the memory size in bytes
+ */
+void buddy_init(buddy_t* buddy, int size);
+
+/**
+ * It releases every block, such that the whole
+ * memory becomes a single free block. Statistics
+ * about past allocations are kept.
+ *
+ * @param buddy the buddy allocator
+ */
+void buddy_reset(buddy_t* buddy);
+
+/**
+ * It allocates a block big enough to hold the
+ * requested amount of memory.
+ *
+ * @param buddy the buddy allocator
+ * @param size the requested size in bytes
+ *
+ * @return the block address or -1 if there is
+ *         no free block big enough.
+ */
+int buddy_alloc(buddy_t* buddy, int size);
+
+/**
+ * It frees the block at the specified address,
+ * merging it with its buddies while they are free.
+ * If there is no block allocated at that address,
+ * then the application is exited.
+ *
+ * @param buddy the buddy allocator
+ * @param addr the block address
+ */
+void buddy_free(buddy_t* buddy, int addr);
+
+/**
+ * It returns the size of the block that would be
+ * handed out for the requested amount of memory.
+ *
+ * @param size the requested size in bytes
+ *
+ * @return the block size in bytes
+ */
+int buddy_block_size(int size);
+
+/**
+ * It returns the size of the largest free block.
+ *
+ * @param buddy the buddy allocator
+ *
+ * @return the largest free block size in bytes
+ */
+int buddy_largest_free(const buddy_t* buddy);
+
+/**
+ * It fills the specified structure with the
+ * current fragmentation information.
+ *
+ * @param buddy the buddy allocator
+ * @param stats the structure to be filled
+ */
+void buddy_stats(const buddy_t* buddy, buddy_stats_t* stats);
+
+#endif // OS_PROJECT_BUDDY_H
@@ -1,8 +1,292 @@
 #include <math.h>
+#include <string.h>
 
 #include "../tools/math.h"
+#include "../tools/slab.h"
 #include "memory.h"
 
+/**
+ * The slab caches from which the segments
+ * and the code images are allocated.
+ */
+static slab_cache_t segment_cache = SLAB_CACHE_INITIALIZER("segment", segment_t);
+static slab_cache_t code_image_cache = SLAB_CACHE_INITIALIZER("code_image", code_image_t);
+
+/* Code Image Internal Function Definitions */
+
+/**
+ * It returns 1 if both code images are the same.
+ * Otherwise, 0 is returned.
+ *
+ * @param i1 the first code image
+ * @param i2 the second code image
+ *
+ * @return 1 if both code images are the same;
+ *         otherwise, 0 is returned.
+ */
+static int code_image_cmp(void* i1, void* i2) {
+    return i1 == i2;
+}
+
+/* Physical Memory Internal Function Prototypes */
+
+/**
+ * It swaps out the pages that are candidates for
+ * being unloaded from the main memory using the
+ * second chance algorithm, until the specified
+ * amount of memory has been freed.
+ *
+ * @param seg_table the segment table
+ * @param needed the amount of memory needed
+ *
+ * @return the amount of memory freed by the
+ *         swapped out pages.
+ */
+static int memory_page_swap(segment_table_t* seg_table, int needed);
+
+/**
+ * It compacts the memory by relocating every segment
+ * and frame. It is supposed that the segment table
+ * mutex is held.
+ *
+ * @param seg_table the segment table
+ */
+static void memory_compact(segment_table_t* seg_table);
+
+/**
+ * It loads the pages following the specified one
+ * back from the swap area, such that they are in
+ * the memory before the process references them.
+ *
+ * @param seg_table the segment table
+ * @param seg the segment
+ * @param page_number the page being referenced
+ */
+static void memory_prefetch(segment_table_t* seg_table, segment_t* seg, int page_number);
+
+/* Physical Memory Internal Function Definitions */
+
+/**
+ * It represents a live allocation in the physical
+ * memory that may be relocated by a compaction.
+ */
+typedef struct {
+    int* addr;
+    int size;
+} mem_alloc_ref_t;
+
+/**
+ * It compares two live allocations by their block
+ * size in descending order.
+ */
+static int mem_alloc_ref_cmp(const void* r1, const void* r2) {
+    return buddy_block_size(((const mem_alloc_ref_t *)r2)->size)
+           - buddy_block_size(((const mem_alloc_ref_t *)r1)->size);
+}
+
+/**
+ * It allocates a block of physical memory. If the
+ * memory has enough free space, but it is too much
+ * fragmented to fit the request, then the memory is
+ * compacted and the allocation retried. Further, if
+ * the memory has not enough free space, then pages
+ * are swapped out before retrying.
+ *
+ * @param seg_table the segment table
+ * @param size the requested size in bytes
+ *
+ * @return the physical address or -1 if there is
+ *         not enough memory.
+ */
+static int memory_alloc(segment_table_t* seg_table, int size) {
+    const int block_size = buddy_block_size(size);
+    int addr = buddy_alloc(&seg_table->buddy, size);
+
+    if (addr < 0 && seg_table->buddy.free_bytes >= block_size) {
+        memory_compact(seg_table);
+        addr = buddy_alloc(&seg_table->buddy, size);
+    }
+
+    /* It checks if the memory is oversubscribed. Therefore, */
+    /* pages are swapped out to make room for the request */
+    if (addr < 0 && memory_page_swap(seg_table, block_size - seg_table->buddy.free_bytes) > 0) {
+        memory_compact(seg_table);
+        addr = buddy_alloc(&seg_table->buddy, size);
+    }
+
+    seg_table->remaining = seg_table->buddy.free_bytes;
+    return addr;
+}
+
+/**
+ * It frees a block of physical memory. Nothing
+ * is done if the address is negative.
+ *
+ * @param seg_table the segment table
+ * @param addr the physical address
+ */
+static void memory_free(segment_table_t* seg_table, int addr) {
+    if (addr < 0)
+        return;
+
+    buddy_free(&seg_table->buddy, addr);
+    seg_table->remaining = seg_table->buddy.free_bytes;
+}
+
+/**
+ * It compacts the memory by relocating every segment
+ * and frame. It is supposed that the segment table
+ * mutex is held.
+ *
+ * @param seg_table the segment table
+ */
+static void memory_compact(segment_table_t* seg_table) {
+    mem_alloc_ref_t* refs;
+    int count = 0;
+    int old_addr;
+    list_node_t* node;
+    register int i;
+
+    for (node = seg_table->image_list->head; node != NULL; node = node->next)
+        count += ((code_image_t *)node->content)->page_count;
+
+    refs = (mem_alloc_ref_t *)malloc(sizeof(mem_alloc_ref_t) * (count + seg_table->seg_list->size + 1));
+
+    /* It checks if the allocation references could not be allocated */
+    if (!refs) {
+        printf("Not enough memory to compact the memory.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* It collects every live allocation, that is, the */
+    /* placed segments and the allocated code frames */
+    count = 0;
+    for (node = seg_table->seg_list->head; node != NULL; node = node->next) {
+        segment_t* seg = (segment_t *)node->content;
+
+        if (seg->base >= 0)
+            refs[count++] = (mem_alloc_ref_t) { &seg->base, seg->size };
+    }
+
+    for (node = seg_table->image_list->head; node != NULL; node = node->next) {
+        code_image_t* image = (code_image_t *)node->content;
+
+        for (i = 0; i < image->page_count; i++)
+            if (image->pages[i].frame >= 0)
+                refs[count++] = (mem_alloc_ref_t) { &image->pages[i].frame, PAGE_SIZE };
+    }
+
+    /* Allocating the largest blocks first from an empty buddy */
+    /* allocator packs the blocks without leaving any hole */
+    qsort(refs, count, sizeof(mem_alloc_ref_t), mem_alloc_ref_cmp);
+    buddy_reset(&seg_table->buddy);
+
+    for (i = 0; i < count; i++) {
+        old_addr = *refs[i].addr;
+        *refs[i].addr = buddy_alloc(&seg_table->buddy, refs[i].size);
+
+        if (*refs[i].addr != old_addr)
+            seg_table->moved_bytes += refs[i].size;
+    }
+
+    seg_table->compactions++;
+    seg_table->remaining = seg_table->buddy.free_bytes;
+
+    free(refs);
+}
+
+/**
+ * It swaps out the pages that are candidates for
+ * being unloaded from the main memory using the
+ * second chance algorithm, until the specified
+ * amount of memory has been freed.
+ *
+ * @param seg_table the segment table
+ * @param needed the amount of memory needed
+ *
+ * @return the amount of memory freed by the
+ *         swapped out pages.
+ */
+static int memory_page_swap(segment_table_t* seg_table, int needed) {
+    list_node_t* node;
+    int freed = 0;
+    int pass;
+    int i;
+
+    /* The first pass may just clear the used bits, */
+    /* hence a second pass is made if needed */
+    for (pass = 0; pass < 2 && freed < needed; pass++) {
+        for (node = seg_table->seg_list->head; node != NULL && freed < needed; node = node->next) {
+            segment_t* seg = (segment_t *)node->content;
+
+            for (i = 0; i < seg->page_count && freed < needed; i++) {
+                page_t* page = seg->page_table + i;
+                code_page_t* code_page = page->code_page;
+
+                /* Only the pages stored in a frame free memory */
+                if (!code_page->code || code_page->frame < 0)
+                    continue;
+
+                /* If the page is being referenced, then the */
+                /* used bit is cleared (giving to it a second chance) */
+                if (page->used)
+                    page->used = 0;
+                else if (swap_out(&seg_table->swap, code_page)) {
+                    memory_free(seg_table, code_page->frame);
+                    code_page->frame = -1;
+
+                    /* It checks if the page has been prefetched for nothing */
+                    if (code_page->prefetched) {
+                        code_page->prefetched = 0;
+                        seg_table->prefetch_wasted++;
+                    }
+
+                    freed += PAGE_SIZE;
+                    seg_table->evict_count++;
+                }
+            }
+        }
+    }
+
+    return freed;
+}
+
+/**
+ * It loads the pages following the specified one
+ * back from the swap area, such that they are in
+ * the memory before the process references them.
+ *
+ * @param seg_table the segment table
+ * @param seg the segment
+ * @param page_number the page being referenced
+ */
+static void memory_prefetch(segment_table_t* seg_table, segment_t* seg, int page_number) {
+    register int i;
+
+    for (i = page_number + 1; i <= page_number + seg_table->prefetch_depth && i < seg->page_count; i++) {
+        page_t* page = seg->page_table + i;
+        code_page_t* code_page = page->code_page;
+
+        /* Only the swapped out pages are prefetched */
+        if (code_page->code)
+            continue;
+
+        /* The prefetching overlaps the execution of the current */
+        /* instructions, hence its time is not charged. Further, */
+        /* it is given up if there is no frame left for the page */
+        if ((code_page->frame = memory_alloc(seg_table, PAGE_SIZE)) < 0)
+            break;
+
+        swap_in(&seg_table->swap, code_page);
+        code_page->prefetched = 1;
+
+        /* The page is given a chance not to be */
+        /* evicted before it is referenced */
+        page->used = 1;
+        seg_table->prefetch_count++;
+    }
+}
+
 /* Segment Internal Function Definitions */
 
 /**
@@ -15,7 +299,7 @@
  * @return a pointer to a segment
  */
 static segment_t* segment_create(memory_request_t* req) {
-    segment_t* seg = (segment_t *)malloc(sizeof(segment_t));
+    segment_t* seg = (segment_t *)slab_alloc(&segment_cache);
 
     /* It checks if the segment could not be allocated */
     if (!seg) {
@@ -25,71 +309,298 @@ static segment_t* segment_create(memory_request_t* req) {
 
     seg->id = req->proc->seg_id;
     seg->size = req->proc->seg_size * KILOBYTE; /* size measure in bytes */
+    seg->base = -1;
     seg->page_count = (int) ceil((double) req->proc->code_len / INSTRUCTIONS_PER_PAGE);
     seg->page_table = (page_t *)malloc(sizeof(page_t) * seg->page_count);
     seg->page_qtd = seg->size / PAGE_SIZE;
+    seg->last_page = -1;
 
     return seg;
 }
 
 /**
- * It populates the segment's page with the
- * program code. Further, it is supposed that
- * the segment is already created.
+ * It computes the hash of the program code. The
+ * hash is computed from the instruction operators,
+ * values, the semaphore names and the paths (FNV-1a).
  *
  * @param code the program code
  * @param code_len the program code length
+ *
+ * @return the hash of the program code
  */
-static void segment_populate(segment_t* seg, instr_t* code, int code_len) {
-    register int i;
-    for (i = 0; i < code_len; i++)
-        seg->page_table[PAGE_NUMBER(i)].used = 0;
-    for (i = 0; i < code_len; i++)
-        seg->page_table[PAGE_NUMBER(i)].code[PAGE_OFFSET(i)] = code[i];
+static unsigned long code_hash(const instr_t* code, int code_len) {
+    unsigned long hash = 14695981039346656037UL;
+    const char* c;
+    int i;
+
+    for (i = 0; i < code_len; i++) {
+        hash = (hash ^ (unsigned long) code[i].op) * 1099511628211UL;
+        hash = (hash ^ (unsigned long) code[i].value) * 1099511628211UL;
+
+        if (code[i].sem)
+            for (c = code[i].sem; *c; c++)
+                hash = (hash ^ (unsigned char) *c) * 1099511628211UL;
+        if (code[i].path)
+            for (c = code[i].path; *c; c++)
+                hash = (hash ^ (unsigned char) *c) * 1099511628211UL;
+    }
+
+    return hash;
 }
 
 /**
- * It adds the specified segment into the segment table.
+ * It loads the specified code page back from the
+ * swap area, allocating a frame to store it. If
+ * no frame could be allocated, even after swapping
+ * pages out, then the page is loaded without one
+ * and it must be dropped right after it is used
+ * (see code_page_drop).
  *
  * @param seg_table the segment table
- * @param seg the segment to be added
+ * @param code_page the code page
+ *
+ * @return the time (u.t.) spent servicing the
+ *         page fault.
  */
-static void segment_add(segment_table_t* seg_table, segment_t* seg) {
-    list_add(seg_table->seg_list, seg);
-    seg_table->seg_list_size++;
+static int code_page_fault(segment_table_t* seg_table, code_page_t* code_page) {
+    long wait_ns;
+
+    code_page->frame = memory_alloc(seg_table, PAGE_SIZE);
+    wait_ns = swap_in(&seg_table->swap, code_page);
+    seg_table->fault_count++;
+
+    /* The time waited for the swap area is charged in microseconds */
+    return SWAP_FAULT_TIME + (int) (wait_ns / 1000);
 }
 
 /**
- * It swaps the necessary pages that are candidates for
- * being unloaded from the main memory using the second
- * chance algorithm to be able to allocate pages provided
- * by a segment.
+ * It drops the specified code page, which has no
+ * frame, from the main memory. A page loaded back
+ * from the swap area keeps its slot, hence it is
+ * just dropped, whereas a new page must be given a
+ * slot. If the swap area is full, then no page may
+ * stay resident without a frame, hence the program
+ * code could not be loaded and the application is
+ * exited.
  *
  * @param seg_table the segment table
- * @param seg the segment containing the pages to
- *            to be loaded into the memory
- * @return the amount of memory freed by unused pages.
+ * @param code_page the code page
  */
-static int memory_page_swap(segment_table_t* seg_table, segment_t* seg) {
-    int i;
-    int freed = 0;
+static void code_page_drop(segment_table_t* seg_table, code_page_t* code_page) {
+    if (!swap_out(&seg_table->swap, code_page)) {
+        printf("Neither the memory nor the swap area may hold a code page.\n");
+        exit(EXIT_FAILURE);
+    }
+}
 
-    FOREACH(seg_table->seg_list, segment_t*) {
-        for (i = 0; i < it->page_count; i++) {
-            page_t* page = it->page_table + i;
+/**
+ * It returns 1 if the code image holds exactly
+ * the specified program code. Otherwise, 0 is
+ * returned.
+ *
+ * @param seg_table the segment table
+ * @param image the code image
+ * @param code the program code
+ * @param code_len the program code length
+ *
+ * @return 1 if the code image holds the program
+ *         code; otherwise, 0 is returned.
+ */
+static int code_image_match(segment_table_t* seg_table, const code_image_t* image,
+                            const instr_t* code, int code_len) {
+    register int i;
+
+    if (image->code_len != code_len)
+        return 0;
+
+    for (i = 0; i < code_len; i++) {
+        code_page_t* code_page = &image->pages[PAGE_NUMBER(i)];
+
+        /* The swapped out pages must be loaded to be compared */
+        if (!code_page->code)
+            code_page_fault(seg_table, code_page);
+
+        const instr_t* instr = &code_page->code[PAGE_OFFSET(i)];
+        const int match = instr->op == code[i].op && instr->value == code[i].value
+                          && (instr->sem == NULL) == (code[i].sem == NULL)
+                          && (!instr->sem || strcmp(instr->sem, code[i].sem) == 0)
+                          && (instr->path == NULL) == (code[i].path == NULL)
+                          && (!instr->path || strcmp(instr->path, code[i].path) == 0);
+
+        /* A page faulted in without a frame is dropped again */
+        /* once it has been compared */
+        if (code_page->frame < 0
+            && (!match || PAGE_OFFSET(i) == INSTRUCTIONS_PER_PAGE - 1 || i == code_len - 1))
+            code_page_drop(seg_table, code_page);
+
+        if (!match)
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * It returns the code image holding the specified
+ * program code. If there is already a code image
+ * with the same content, then it is shared and its
+ * reference count is incremented. Otherwise, a new
+ * code image is created and populated.
+ *
+ * @param seg_table the segment table
+ * @param code the program code
+ * @param code_len the program code length
+ *
+ * @return a pointer to the code image
+ */
+static code_image_t* code_image_acquire(segment_table_t* seg_table, const instr_t* code, int code_len) {
+    const unsigned long hash = code_hash(code, code_len);
+    code_image_t* image;
+    register int i;
+
+    FOREACH(seg_table->image_list, code_image_t*) {
+        if (it->hash == hash && code_image_match(seg_table, it, code, code_len)) {
+            it->ref_count++;
+            return it;
+        }
+    }
 
-            /* If the page is being referenced, then the */
-            /* used bit is cleared (giving to it a second chance) */
-            if (page->used)
-                page->used = 0;
-            else freed += PAGE_SIZE;
+    image = (code_image_t *)slab_alloc(&code_image_cache);
 
-            if (freed >= seg->size)
-                break;
+    /* It checks if the code image could not be allocated */
+    if (!image) {
+        printf("Not enough memory to allocate a code image.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    image->hash = hash;
+    image->code_len = code_len;
+    image->page_count = (int) ceil((double) code_len / INSTRUCTIONS_PER_PAGE);
+    image->pages = (code_page_t *)malloc(sizeof(code_page_t) * image->page_count);
+    image->ref_count = 1;
+
+    /* It checks if the code pages could not be allocated */
+    if (image->page_count > 0 && !image->pages) {
+        printf("Not enough memory to allocate the code pages.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate the code pages, which have no frame yet */
+    for (i = 0; i < image->page_count; i++) {
+        image->pages[i].code = (instr_t *)malloc(sizeof(instr_t) * INSTRUCTIONS_PER_PAGE);
+        image->pages[i].frame = -1;
+        image->pages[i].slot = -1;
+        image->pages[i].io = NULL;
+        image->pages[i].prefetched = 0;
+
+        /* It checks if the page code could not be allocated */
+        if (!image->pages[i].code) {
+            printf("Not enough memory to allocate a code page.\n");
+            exit(EXIT_FAILURE);
         }
     }
 
-    return freed;
+    /* The image is listed before its frames are allocated, such */
+    /* that a compaction triggered meanwhile relocates them too */
+    list_add(seg_table->image_list, image);
+
+    for (i = 0; i < image->page_count; i++)
+        image->pages[i].frame = memory_alloc(seg_table, PAGE_SIZE);
+
+    image->strings = (char **)malloc(sizeof(char *) * 2 * (code_len > 0 ? code_len : 1));
+    image->string_count = 0;
+
+    /* It checks if the string table could not be allocated */
+    if (!image->strings) {
+        printf("Not enough memory to allocate the code strings.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Populate the code pages with the program code, whose */
+    /* strings are copied into the string table of the image */
+    for (i = 0; i < code_len; i++) {
+        instr_t* instr = &image->pages[PAGE_NUMBER(i)].code[PAGE_OFFSET(i)];
+
+        *instr = code[i];
+        if (instr->sem)
+            instr->sem = image->strings[image->string_count++] = strdup(instr->sem);
+        if (instr->path)
+            instr->path = image->strings[image->string_count++] = strdup(instr->path);
+    }
+
+    /* The pages that could not be given a frame are */
+    /* swapped out right away rather than kept resident */
+    for (i = 0; i < image->page_count; i++)
+        if (image->pages[i].frame < 0)
+            code_page_drop(seg_table, &image->pages[i]);
+
+    return image;
+}
+
+/**
+ * It releases a reference to the specified code image.
+ * If no segment is mapping the code image anymore,
+ * then its code pages are freed.
+ *
+ * @param seg_table the segment table
+ * @param image the code image
+ */
+static void code_image_release(segment_table_t* seg_table, code_image_t* image) {
+    list_node_t* image_node;
+    register int i;
+
+    if (--image->ref_count > 0)
+        return;
+
+    if ((image_node = list_search(seg_table->image_list, image, code_image_cmp))) {
+        list_remove_node(seg_table->image_list, image_node);
+        list_node_free(image_node);
+    }
+
+    for (i = 0; i < image->page_count; i++) {
+        if (image->pages[i].prefetched)
+            seg_table->prefetch_wasted++;
+
+        swap_release(&seg_table->swap, &image->pages[i]);
+        memory_free(seg_table, image->pages[i].frame);
+        free(image->pages[i].code);
+    }
+
+    for (i = 0; i < image->string_count; i++)
+        free(image->strings[i]);
+
+    free(image->strings);
+    free(image->pages);
+    slab_free(&code_image_cache, image);
+}
+
+/**
+ * It maps the code image pages into the segment's
+ * page table. Further, it is supposed that the
+ * segment is already created.
+ *
+ * @param seg the segment
+ * @param image the code image
+ */
+static void segment_map(segment_t* seg, code_image_t* image) {
+    register int i;
+
+    seg->image = image;
+    for (i = 0; i < seg->page_count; i++) {
+        seg->page_table[i].code_page = &image->pages[i];
+        seg->page_table[i].used = 0;
+    }
+}
+
+/**
+ * It adds the specified segment into the segment table.
+ *
+ * @param seg_table the segment table
+ * @param seg the segment to be added
+ */
+static void segment_add(segment_table_t* seg_table, segment_t* seg) {
+    list_add(seg_table->seg_list, seg);
+    seg_table->seg_list_size++;
 }
 
 /* Segment Table Function Definitions */
@@ -102,7 +613,68 @@ static int memory_page_swap(segment_table_t* seg_table, segment_t* seg) {
 void segment_table_init(segment_table_t* seg_table) {
     seg_table->seg_list = list_init();
     seg_table->seg_list_size = 0;
-    seg_table->remaining = 1024 * 1024 * 1024;
+    seg_table->image_list = list_init();
+    seg_table->remaining = MAX_MEM_SIZE;
+    seg_table->compactions = 0;
+    seg_table->moved_bytes = 0;
+    seg_table->overcommitted = 0;
+
+    seg_table->fault_count = 0;
+    seg_table->evict_count = 0;
+    seg_table->prefetch_depth = MEM_PREFETCH_DEPTH;
+    seg_table->prefetch_count = 0;
+    seg_table->prefetch_hits = 0;
+    seg_table->prefetch_wasted = 0;
+
+    buddy_init(&seg_table->buddy, MAX_MEM_SIZE);
+    swap_init(&seg_table->swap);
+    pthread_mutex_init(&seg_table->mutex, NULL);
+}
+
+/**
+ * It compacts the memory by relocating every segment
+ * and frame, the largest first, such that the free
+ * memory is coalesced into the fewest blocks.
+ *
+ * @param seg_table the segment table
+ */
+void segment_table_compact(segment_table_t* seg_table) {
+    pthread_mutex_lock(&seg_table->mutex);
+    memory_compact(seg_table);
+    pthread_mutex_unlock(&seg_table->mutex);
+}
+
+/**
+ * It prints the allocation, the paging and
+ * the swapping statistics of the segment table.
+ *
+ * @param seg_table the segment table
+ * @param fp the file to be printed to
+ */
+void segment_table_report(segment_table_t* seg_table, FILE* fp) {
+    const swap_t* swap = &seg_table->swap;
+    const buddy_t* buddy = &seg_table->buddy;
+    buddy_stats_t stats;
+
+    pthread_mutex_lock(&seg_table->mutex);
+
+    buddy_stats(buddy, &stats);
+    fprintf(fp, "Buddy: %ld allocations (%ld failed), internal fragmentation %.1lf%%, "
+                "external fragmentation %.1lf%%, alloc %.0lf ns mean (%ld ns max)\n",
+            buddy->alloc_count, buddy->failed_count, stats.internal_frag * 100.0,
+            stats.external_frag * 100.0, stats.mean_alloc_ns, buddy->alloc_ns_max);
+
+    fprintf(fp, "Paging: %ld faults, %ld evictions, %d compactions (%ld bytes moved)\n",
+            seg_table->fault_count, seg_table->evict_count, seg_table->compactions,
+            seg_table->moved_bytes);
+    fprintf(fp, "Swap: %ld written, %ld read, %ld clean evictions, %ld reclaimed\n",
+            swap->out_count, swap->in_count, swap->clean_count, swap->reclaim_count);
+    fprintf(fp, "Prefetch (depth %d): %ld issued, %ld faults avoided, %ld wasted, accuracy %.1lf%%\n",
+            seg_table->prefetch_depth, seg_table->prefetch_count, seg_table->prefetch_hits,
+            seg_table->prefetch_wasted, seg_table->prefetch_count > 0
+            ? 100.0 * seg_table->prefetch_hits / seg_table->prefetch_count : 0.0);
+
+    pthread_mutex_unlock(&seg_table->mutex);
 }
 
 /* Segment Function Definitions */
@@ -151,18 +723,76 @@ void segment_free(segment_table_t* seg_table, int sid) {
         exit(EXIT_FAILURE);
     }
 
+    pthread_mutex_lock(&seg_table->mutex);
+
     /* Remove the segment node from the segment table list */
     list_remove_node(seg_table->seg_list, seg_node);
 
     segment_t* seg = (segment_t *)seg_node->content;
 
-    /* It sums the freed memory to the amount of */
-    /* addressable memory space */
-    seg_table->remaining = MIN(MAX_MEM_SIZE, seg_table->remaining + seg->size);
+    /* It releases the physical memory used by the segment */
+    if (seg->base < 0)
+        seg_table->overcommitted--;
+    memory_free(seg_table, seg->base);
+
+    /* It unmaps the (possibly shared) code image */
+    code_image_release(seg_table, seg->image);
+
+    pthread_mutex_unlock(&seg_table->mutex);
 
     free(seg->page_table);
-    free(seg);
-    free(seg_node);
+    slab_free(&segment_cache, seg);
+    list_node_free(seg_node);
+}
+
+/**
+ * It fetches the instruction at the specified address
+ * of the segment. If the page holding the instruction
+ * has been swapped out, then it is faulted back in.
+ *
+ * @param seg_table the segment table
+ * @param seg the segment
+ * @param pc the instruction address
+ * @param instr a pointer to receive the instruction
+ *
+ * @return the time (u.t.) spent servicing a page
+ *         fault or 0 if the page was in memory.
+ */
+int memory_fetch(segment_table_t* seg_table, segment_t* seg, int pc, instr_t* instr) {
+    const int page_number = PAGE_NUMBER(pc);
+    page_t* page = &seg->page_table[page_number];
+    int fault_time = 0;
+
+    pthread_mutex_lock(&seg_table->mutex);
+
+    /* It checks if the page has been swapped out */
+    if (!page->code_page->code)
+        fault_time = code_page_fault(seg_table, page->code_page);
+    /* It checks if the page fault has been avoided by the prefetching */
+    else if (page->code_page->prefetched) {
+        page->code_page->prefetched = 0;
+        seg_table->prefetch_hits++;
+    }
+
+    *instr = page->code_page->code[PAGE_OFFSET(pc)];
+
+    /* A page faulted in without a frame is dropped again, */
+    /* such that it is never resident outside the memory */
+    if (page->code_page->frame < 0)
+        code_page_drop(seg_table, page->code_page);
+
+    /* It set the used bit if it is not set */
+    if (!page->used)
+        page->used = 1;
+
+    /* It checks if the segment is being accessed sequentially, */
+    /* hence the following pages are going to be referenced */
+    if (page_number == seg->last_page + 1)
+        memory_prefetch(seg_table, seg, page_number);
+    seg->last_page = page_number;
+
+    pthread_mutex_unlock(&seg_table->mutex);
+    return fault_time;
 }
 
 /* Memory Request Function Definitions */
@@ -189,22 +819,20 @@ void mem_req_init(memory_request_t* req, process_t* proc, instr_t* code) {
 void mem_req_load(memory_request_t* req, segment_table_t* seg_table) {
     segment_t* seg = segment_create(req);
 
-    const int new_remaining = seg_table->remaining - seg->size;
+    pthread_mutex_lock(&seg_table->mutex);
 
-    /* Update the remaining addressable memory space */
-    seg_table->remaining = MAX(0, new_remaining);
+    /* Map the segment's pages to the (possibly shared) program code */
+    segment_map(seg, code_image_acquire(seg_table, req->code, req->proc->code_len));
 
-    /* If checks if the request memory segment could not */
-    /* be allocated into the memory space because this */
-    /* does not have enough. Therefore, a page swapping */
-    /* must occur */
-    if (new_remaining < 0) {
-        /* Invoke the page swapping */
-        seg_table->remaining += memory_page_swap(seg_table, seg);
-    }
+    /* It places the segment into the physical memory */
+    seg->base = memory_alloc(seg_table, seg->size);
+
+    /* It checks if the segment could not be placed even */
+    /* after swapping pages out, hence it is overcommitted */
+    if (seg->base < 0)
+        seg_table->overcommitted++;
 
-    /* Populate the segment's page with the program code */
-    segment_populate(seg, req->code, req->proc->code_len);
     segment_add(seg_table, seg);
-}
 
+    pthread_mutex_unlock(&seg_table->mutex);
+}
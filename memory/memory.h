@@ -5,6 +5,8 @@
 #include "../process/instruction.h"
 #include "../process/process.h"
 #include "../semaphore/semaphore.h"
+#include "buddy.h"
+#include "swap.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -20,8 +22,109 @@
 #define PAGE_NUMBER(x) ((x) / INSTRUCTIONS_PER_PAGE)
 #define PAGE_OFFSET(x) ((x) % INSTRUCTIONS_PER_PAGE)
 
+/**
+ * It represents the default amount of pages
+ * ahead that are prefetched once a segment is
+ * detected to be accessed sequentially.
+ */
+#define MEM_PREFETCH_DEPTH (2)
+
+/**
+ * It represents a read-only page holding a
+ * portion of a program code. Code pages are
+ * shared among the segments whose processes
+ * have been loaded from the same program.
+ */
+typedef struct CodePage {
+    /**
+     * It holds the page code. It is NULL
+     * while the page is swapped out.
+     */
+    instr_t* code;
+
+    /**
+     * It holds the physical address of the
+     * frame storing this page or -1 if no
+     * frame could be allocated.
+     */
+    int frame;
+
+    /**
+     * It holds the swap slot containing a
+     * copy of this page or -1 if the page
+     * has never been swapped out.
+     */
+    int slot;
+
+    /**
+     * It points to the pending write-back
+     * of this page or NULL if there is none.
+     */
+    swap_io_t* io;
+
+    /**
+     * It is set when the page has been
+     * prefetched and it has not been
+     * referenced since then.
+     */
+    int prefetched;
+} code_page_t;
+
+/**
+ * It represents the code of a program loaded
+ * into the memory. Identical programs map to
+ * the same code image, that is reference counted
+ * by the segments using it.
+ */
+typedef struct CodeImage {
+    /**
+     * It holds the hash computed from
+     * the program code content.
+     */
+    unsigned long hash;
+
+    /**
+     * It holds the program code length
+     * measured in instructions.
+     */
+    int code_len;
+
+    /**
+     * It holds the code pages and
+     * the amount of them.
+     */
+    code_page_t* pages;
+    int page_count;
+
+    /**
+     * It holds the semaphore names and the paths
+     * the code refers to, and the amount of them.
+     * They are kept out of the code pages, such that
+     * they stay resident while the pages are swapped
+     * out, and they are freed along with the image.
+     */
+    char** strings;
+    int string_count;
+
+    /**
+     * It holds the amount of segments
+     * that are mapping this code image.
+     */
+    int ref_count;
+} code_image_t;
+
 typedef struct Page {
-    instr_t code[INSTRUCTIONS_PER_PAGE];
+    /**
+     * It points to the shared code
+     * page mapped by this page.
+     */
+    code_page_t* code_page;
+
+    /**
+     * It is set when the page has been
+     * referenced by the process. This
+     * information is per-process.
+     */
     int used;
 } page_t;
 
@@ -38,10 +141,29 @@ typedef struct Segment {
      */
     int size;
 
+    /**
+     * It holds the physical address in which
+     * the segment has been placed or -1 if
+     * it could not be placed.
+     */
+    int base;
+
+    /**
+     * It points to the (possibly shared)
+     * code image mapped by this segment.
+     */
+    code_image_t* image;
+
     /* Page Table Information */
     page_t* page_table;
     int page_count;
     int page_qtd;
+
+    /**
+     * It holds the last referenced page,
+     * used to detect sequential access.
+     */
+    int last_page;
 } segment_t;
 
 typedef struct Segment_Table {
@@ -58,12 +180,78 @@ typedef struct Segment_Table {
      */
     int seg_list_size;
 
+    /**
+     * The list containing the code
+     * images that are mapped by at
+     * least one segment.
+     */
+    list_t* image_list;
+
     /**
      * It holds the amount of available
      * memory to be used by processes in
      * bytes.
      */
     int remaining;
+
+    /**
+     * It represents the physical memory
+     * in which segments and frames are
+     * allocated.
+     */
+    buddy_t buddy;
+
+    /**
+     * It holds the amount of compaction
+     * passes and the amount of bytes that
+     * have been moved by them.
+     */
+    int compactions;
+    long moved_bytes;
+
+    /**
+     * It holds the amount of segments that
+     * could not be placed in the memory.
+     */
+    int overcommitted;
+
+    /**
+     * It represents the swap area in which
+     * the evicted pages are stored.
+     */
+    swap_t swap;
+
+    /**
+     * It holds the amount of page faults
+     * and the amount of evicted pages.
+     */
+    long fault_count;
+    long evict_count;
+
+    /**
+     * It holds the amount of pages ahead
+     * that are prefetched (0 disables the
+     * prefetching).
+     */
+    int prefetch_depth;
+
+    /**
+     * It holds the amount of prefetched
+     * pages, the amount of them that have
+     * been referenced (a page fault has been
+     * avoided) and the amount of them that
+     * have been evicted or released without
+     * being referenced.
+     */
+    long prefetch_count;
+    long prefetch_hits;
+    long prefetch_wasted;
+
+    /**
+     * It ensures mutual exclusion when
+     * loading and evicting pages.
+     */
+    pthread_mutex_t mutex;
 } segment_table_t;
 
 /**
@@ -96,6 +284,24 @@ typedef struct {
  */
 void segment_table_init(segment_table_t* seg_table);
 
+/**
+ * It compacts the memory by relocating every segment
+ * and frame, the largest first, such that the free
+ * memory is coalesced into the fewest blocks.
+ *
+ * @param seg_table the segment table
+ */
+void segment_table_compact(segment_table_t* seg_table);
+
+/**
+ * It prints the allocation, the paging and
+ * the swapping statistics of the segment table.
+ *
+ * @param seg_table the segment table
+ * @param fp the file to be printed to
+ */
+void segment_table_report(segment_table_t* seg_table, FILE* fp);
+
 /* Segment Function Prototypes */
 
 /**
@@ -123,6 +329,21 @@ segment_t* segment_find(segment_table_t* seg_table, int sid);
  */
 void segment_free(segment_table_t* seg_table, int sid);
 
+/**
+ * It fetches the instruction at the specified address
+ * of the segment. If the page holding the instruction
+ * has been swapped out, then it is faulted back in.
+ *
+ * @param seg_table the segment table
+ * @param seg the segment
+ * @param pc the instruction address
+ * @param instr a pointer to receive the instruction
+ *
+ * @return the time (u.t.) spent servicing a page
+ *         fault or 0 if the page was in memory.
+ */
+int memory_fetch(segment_table_t* seg_table, segment_t* seg, int pc, instr_t* instr);
+
 /* Memory Request Function Prototypes */
 
 /**
@@ -0,0 +1,313 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../tools/slab.h"
+#include "memory.h"
+#include "swap.h"
+
+/**
+ * The slab cache from which the
+ * write-backs are allocated.
+ */
+static slab_cache_t swap_io_cache = SLAB_CACHE_INITIALIZER("swap_io", swap_io_t);
+
+/* Swap Internal Function Prototypes */
+
+/**
+ * It represents the function that is going to
+ * write the queued pages back to the swap area.
+ *
+ * @param swap the swap device
+ */
+_Noreturn static void* swap_writer(void* swap);
+
+/**
+ * It returns the elapsed time between both
+ * timestamps in nanoseconds.
+ */
+static long elapsed_ns(const struct timespec* start, const struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) * 1000000000L + (end->tv_nsec - start->tv_nsec);
+}
+
+/**
+ * It returns 1 if both write-backs are the same.
+ * Otherwise, 0 is returned.
+ */
+static int swap_io_cmp(void* io1, void* io2) {
+    return io1 == io2;
+}
+
+/**
+ * It removes the write-back of the specified page
+ * from the queue if the writer thread has not taken
+ * it yet. Otherwise, it waits for the write-back to
+ * finish. It is supposed that the swap mutex is held.
+ *
+ * @param swap the swap device
+ * @param page the page
+ *
+ * @return the page code if the write-back has been
+ *         cancelled; otherwise, NULL is returned.
+ */
+static instr_t* swap_cancel(swap_t* swap, code_page_t* page) {
+    swap_io_t* io = page->io;
+    instr_t* code;
+
+    if (!io)
+        return NULL;
+
+    if (io->in_flight) {
+        while (page->io)
+            pthread_cond_wait(&swap->written, &swap->mutex);
+        return NULL;
+    }
+
+    list_node_t* io_node = list_search(swap->write_queue, io, swap_io_cmp);
+    list_remove_node(swap->write_queue, io_node);
+    list_node_free(io_node);
+
+    code = io->code;
+    page->io = NULL;
+    slab_free(&swap_io_cache, io);
+
+    return code;
+}
+
+/* Swap Device Function Definitions */
+
+/**
+ * It initializes the swap device opening its
+ * backing file and it starts the writer thread.
+ *
+ * @param swap the swap device
+ */
+void swap_init(swap_t* swap) {
+    pthread_t writer_id;
+    register int i;
+
+    swap->fd = open(SWAP_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+    /* It checks if the swap file could not be created. The file */
+    /* is sized up front, however, it stays sparse until written */
+    if (swap->fd < 0 || ftruncate(swap->fd, (off_t) SWAP_SLOT_COUNT * SWAP_SLOT_SIZE) < 0) {
+        printf("The swap file %s could not be created.\n", SWAP_FILE_PATH);
+        exit(EXIT_FAILURE);
+    }
+    unlink(SWAP_FILE_PATH);
+
+    swap->free_slots = (int *)malloc(sizeof(int) * SWAP_SLOT_COUNT);
+
+    /* It checks if the free slots could not be allocated */
+    if (!swap->free_slots) {
+        printf("Not enough memory to allocate the swap slots.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The lowest slots are on the top of the stack */
+    for (i = 0; i < SWAP_SLOT_COUNT; i++)
+        swap->free_slots[i] = SWAP_SLOT_COUNT - 1 - i;
+    swap->free_count = SWAP_SLOT_COUNT;
+
+    swap->write_queue = list_init();
+    pthread_mutex_init(&swap->mutex, NULL);
+    pthread_cond_init(&swap->queued, NULL);
+    pthread_cond_init(&swap->written, NULL);
+
+    swap->out_count = 0;
+    swap->in_count = 0;
+    swap->clean_count = 0;
+    swap->reclaim_count = 0;
+    swap->write_ns = 0;
+    swap->wait_ns = 0;
+
+    pthread_create(&writer_id, NULL, swap_writer, swap);
+}
+
+/**
+ * It swaps the specified page out. If the page
+ * is not in the swap area yet, then a slot is
+ * allocated and its write-back is queued to the
+ * writer thread. Otherwise, the page is clean
+ * and it is just dropped.
+ *
+ * @param swap the swap device
+ * @param page the page to be swapped out
+ *
+ * @return 1 if the page has been swapped out;
+ *         otherwise, if there is no free slot,
+ *         0 is returned.
+ */
+int swap_out(swap_t* swap, code_page_t* page) {
+    pthread_mutex_lock(&swap->mutex);
+
+    /* The code pages are read-only, therefore, a page */
+    /* that already has a slot is identical to its copy */
+    if (page->slot >= 0) {
+        free(page->code);
+        page->code = NULL;
+        swap->clean_count++;
+
+        pthread_mutex_unlock(&swap->mutex);
+        return 1;
+    }
+
+    /* It checks if the swap area is full */
+    if (swap->free_count == 0) {
+        pthread_mutex_unlock(&swap->mutex);
+        return 0;
+    }
+
+    swap_io_t* io = (swap_io_t *)slab_alloc(&swap_io_cache);
+
+    /* It checks if the write-back could not be allocated */
+    if (!io) {
+        printf("Not enough memory to allocate a swap write-back.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    page->slot = swap->free_slots[--swap->free_count];
+
+    io->page = page;
+    io->code = page->code;
+    io->slot = page->slot;
+    io->in_flight = 0;
+
+    page->io = io;
+    page->code = NULL;
+
+    /* It queues the write-back and wakes the writer thread up */
+    list_add(swap->write_queue, io);
+    pthread_cond_signal(&swap->queued);
+
+    pthread_mutex_unlock(&swap->mutex);
+    return 1;
+}
+
+/**
+ * It swaps the specified page in, waiting for
+ * its write-back to finish if it is being written.
+ *
+ * @param swap the swap device
+ * @param page the page to be swapped in
+ *
+ * @return the time waited in nanoseconds
+ */
+long swap_in(swap_t* swap, code_page_t* page) {
+    struct timespec start;
+    struct timespec end;
+    instr_t* code;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_mutex_lock(&swap->mutex);
+
+    /* If the page has not been written yet, then its */
+    /* code is reclaimed from the queued write-back */
+    if ((code = swap_cancel(swap, page))) {
+        /* The slot has not been written, hence it is released */
+        swap->free_slots[swap->free_count++] = page->slot;
+        page->slot = -1;
+        swap->reclaim_count++;
+    } else {
+        code = (instr_t *)malloc(SWAP_SLOT_SIZE);
+
+        /* It checks if the page code could not be allocated */
+        if (!code) {
+            printf("Not enough memory to swap a page in.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (pread(swap->fd, code, SWAP_SLOT_SIZE, (off_t) page->slot * SWAP_SLOT_SIZE) != SWAP_SLOT_SIZE) {
+            printf("The page at the swap slot %d could not be read.\n", page->slot);
+            exit(EXIT_FAILURE);
+        }
+
+        swap->in_count++;
+    }
+
+    page->code = code;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    swap->wait_ns += elapsed_ns(&start, &end);
+
+    pthread_mutex_unlock(&swap->mutex);
+    return elapsed_ns(&start, &end);
+}
+
+/**
+ * It releases the swap slot used by the page.
+ * If the page write-back is still queued, then
+ * the write-back is cancelled as well.
+ *
+ * @param swap the swap device
+ * @param page the page
+ */
+void swap_release(swap_t* swap, code_page_t* page) {
+    pthread_mutex_lock(&swap->mutex);
+
+    free(swap_cancel(swap, page));
+
+    if (page->slot >= 0) {
+        swap->free_slots[swap->free_count++] = page->slot;
+        page->slot = -1;
+    }
+
+    pthread_mutex_unlock(&swap->mutex);
+}
+
+/* Swap Internal Function Definitions */
+
+/**
+ * It represents the function that is going to
+ * write the queued pages back to the swap area.
+ *
+ * @param swap the swap device
+ */
+_Noreturn static void* swap_writer(void* arg) {
+    swap_t* swap = (swap_t *)arg;
+    struct timespec start;
+    struct timespec end;
+
+    while (1) {
+        pthread_mutex_lock(&swap->mutex);
+
+        while (list_empty(swap->write_queue))
+            pthread_cond_wait(&swap->queued, &swap->mutex);
+
+        list_node_t* io_node = list_remove_head(swap->write_queue);
+        swap_io_t* io = (swap_io_t *)io_node->content;
+
+        list_node_free(io_node);
+        io->in_flight = 1;
+
+        pthread_mutex_unlock(&swap->mutex);
+
+        /* The page is written without holding the mutex, such */
+        /* that other pages may be swapped out meanwhile. Its */
+        /* semaphore names and paths point to the string table */
+        /* of its code image, which stays resident while any of */
+        /* its pages are swapped out (see code_image_t) */
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (pwrite(swap->fd, io->code, SWAP_SLOT_SIZE, (off_t) io->slot * SWAP_SLOT_SIZE) != SWAP_SLOT_SIZE) {
+            printf("The page at the swap slot %d could not be written.\n", io->slot);
+            exit(EXIT_FAILURE);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        pthread_mutex_lock(&swap->mutex);
+
+        swap->out_count++;
+        swap->write_ns += elapsed_ns(&start, &end);
+
+        /* It signals the page faults waiting for this write-back */
+        io->page->io = NULL;
+        pthread_cond_broadcast(&swap->written);
+
+        pthread_mutex_unlock(&swap->mutex);
+
+        free(io->code);
+        slab_free(&swap_io_cache, io);
+    }
+}
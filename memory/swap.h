@@ -0,0 +1,171 @@
+#ifndef OS_PROJECT_SWAP_H
+#define OS_PROJECT_SWAP_H
+
+#include <pthread.h>
+
+#include "../tools/list.h"
+#include "../process/instruction.h"
+
+/**
+ * It represents the host file backing the swap
+ * area. The file is unlinked as soon as it is
+ * opened, hence it does not outlive the simulator.
+ */
+#define SWAP_FILE_PATH "ribabari.swap"
+
+/**
+ * It represents the amount of page slots in the
+ * swap area. The backing file is sparse, hence
+ * only the written slots use host storage.
+ */
+#define SWAP_SLOT_COUNT (256 * 1024)
+
+/**
+ * It represents the size of a swap
+ * slot, that is, the code of a page.
+ */
+#define SWAP_SLOT_SIZE (sizeof(instr_t) * INSTRUCTIONS_PER_PAGE)
+
+/**
+ * It represents the amount of time (u.t.)
+ * charged to a process for servicing a page
+ * fault, besides the time it has waited for
+ * the swap area itself.
+ */
+#define SWAP_FAULT_TIME (500)
+
+struct CodePage;
+
+/**
+ * It represents a page write-back that has been
+ * queued to the swap writer thread.
+ */
+typedef struct SwapIo {
+    /**
+     * The page being written back and
+     * the page code to be written.
+     */
+    struct CodePage* page;
+    instr_t* code;
+
+    /**
+     * It holds the slot in which
+     * the page is being written.
+     */
+    int slot;
+
+    /**
+     * It is set when the writer thread
+     * has taken the write-back from the
+     * queue and it is writing it.
+     */
+    int in_flight;
+} swap_io_t;
+
+typedef struct SwapDevice {
+    /**
+     * It holds the backing
+     * file descriptor.
+     */
+    int fd;
+
+    /**
+     * A stack containing the free slots.
+     */
+    int* free_slots;
+    int free_count;
+
+    /**
+     * It holds the queued write-backs
+     * waiting for the writer thread.
+     */
+    list_t* write_queue;
+
+    /**
+     * It ensures mutual exclusion when
+     * handling the swap device, signals
+     * the writer thread about queued
+     * write-backs and signals the page
+     * faults about finished write-backs.
+     */
+    pthread_mutex_t mutex;
+    pthread_cond_t queued;
+    pthread_cond_t written;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of pages written
+     * to and read from the swap area.
+     */
+    long out_count;
+    long in_count;
+
+    /**
+     * It holds the amount of clean pages
+     * that have been evicted without being
+     * written (they were already in the swap
+     * area), and the amount of faulted pages
+     * that have been reclaimed before their
+     * write-back happened.
+     */
+    long clean_count;
+    long reclaim_count;
+
+    /**
+     * It holds the total time spent writing
+     * pages and waiting for swap-ins measured
+     * in nanoseconds.
+     */
+    long write_ns;
+    long wait_ns;
+} swap_t;
+
+/* Swap Device Function Prototypes */
+
+/**
+ * It initializes the swap device opening its
+ * backing file and it starts the writer thread.
+ *
+ * @param swap the swap device
+ */
+void swap_init(swap_t* swap);
+
+/**
+ * It swaps the specified page out. If the page
+ * is not in the swap area yet, then a slot is
+ * allocated and its write-back is queued to the
+ * writer thread. Otherwise, the page is clean
+ * and it is just dropped.
+ *
+ * @param swap the swap device
+ * @param page the page to be swapped out
+ *
+ * @return 1 if the page has been swapped out;
+ *         otherwise, if there is no free slot,
+ *         0 is returned.
+ */
+int swap_out(swap_t* swap, struct CodePage* page);
+
+/**
+ * It swaps the specified page in, waiting for
+ * its write-back to finish if it is being written.
+ *
+ * @param swap the swap device
+ * @param page the page to be swapped in
+ *
+ * @return the time waited in nanoseconds
+ */
+long swap_in(swap_t* swap, struct CodePage* page);
+
+/**
+ * It releases the swap slot used by the page.
+ * If the page write-back is still queued, then
+ * the write-back is cancelled as well.
+ *
+ * @param swap the swap device
+ * @param page the page
+ */
+void swap_release(swap_t* swap, struct CodePage* page);
+
+#endif // OS_PROJECT_SWAP_H
@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fd_table.h"
+
+/**
+ * It returns the files of the table, either
+ * those inside it or those on the heap.
+ */
+#define FD_TABLE_FILES(fd_table) ((fd_table)->files ? (fd_table)->files : (fd_table)->inline_files)
+
+/* Internal File Descriptor Table Function Prototypes */
+
+/**
+ * It returns the home slot of the specified inode
+ * number in the hash set, that is, the slot its
+ * probing starts at.
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+static int fd_table_home(const fd_table_t* fd_table, int inumber);
+
+/**
+ * It returns the slot of the hash set holding the
+ * descriptor of the specified inode number or, if
+ * it has not been opened, the empty slot it would
+ * be stored at (linear probing).
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+static int fd_table_slot(const fd_table_t* fd_table, int inumber);
+
+/**
+ * It makes room for one more descriptor, moving the
+ * files to the heap or doubling them. If there is not
+ * enough memory, then the application is exited.
+ *
+ * @param fd_table the file descriptor table
+ */
+static void fd_table_grow(fd_table_t* fd_table);
+
+/**
+ * It rebuilds the hash set with the specified
+ * amount of slots. If there is not enough memory
+ * to allocate them, then the application is exited.
+ *
+ * @param fd_table the file descriptor table
+ * @param slot_count the amount of slots
+ */
+static void fd_table_rehash(fd_table_t* fd_table, int slot_count);
+
+/* File Descriptor Table Function Definitions */
+
+/**
+ * It initializes the file descriptor table.
+ *
+ * @param fd_table the file descriptor table
+ */
+void fd_table_init(fd_table_t* fd_table) {
+    fd_table->files = NULL;
+    fd_table->size = 0;
+    fd_table->length = 0;
+    fd_table->capacity = FD_TABLE_INLINE;
+    fd_table->first_free = 0;
+    fd_table->slots = NULL;
+    fd_table->slot_count = 0;
+}
+
+/**
+ * It returns the descriptor of the file with the
+ * specified inode number. If the file has not been
+ * opened, then -1 is returned.
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+int fd_table_find(const fd_table_t* fd_table, int inumber) {
+    register int i;
+
+    if (!fd_table->slots) {
+        for (i = 0; i < fd_table->length; i++)
+            if (fd_table->inline_files[i] == inumber)
+                return i + FD_TABLE_FIRST_FD;
+        return -1;
+    }
+
+    return fd_table->slots[fd_table_slot(fd_table, inumber)];
+}
+
+/**
+ * It opens the file with the specified inode number,
+ * which is supposed not to be open yet, and it returns
+ * its descriptor (the lowest one not taken). If there
+ * is not enough memory, then the application is exited.
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+int fd_table_open(fd_table_t* fd_table, int inumber) {
+    int index = fd_table->length;
+
+    /* It checks if a closed descriptor may be handed out again */
+    if (fd_table->size < fd_table->length) {
+        for (index = fd_table->first_free; FD_TABLE_FILES(fd_table)[index] != -1; index++);
+        fd_table->first_free = index + 1;
+    } else {
+        if (fd_table->length == fd_table->capacity)
+            fd_table_grow(fd_table);
+
+        fd_table->length++;
+        fd_table->first_free = fd_table->length;
+    }
+
+    FD_TABLE_FILES(fd_table)[index] = inumber;
+    fd_table->size++;
+
+    /* It checks if the hash set is either missing or too loaded */
+    if (fd_table->files && 100 * fd_table->size > FD_TABLE_MAX_LOAD * fd_table->slot_count)
+        fd_table_rehash(fd_table, fd_table->slot_count ? 2 * fd_table->slot_count : 4 * FD_TABLE_INLINE);
+    else if (fd_table->slots)
+        fd_table->slots[fd_table_slot(fd_table, inumber)] = index + FD_TABLE_FIRST_FD;
+
+    return index + FD_TABLE_FIRST_FD;
+}
+
+/**
+ * It closes the specified descriptor and it returns
+ * the inode number it referred to. If the descriptor
+ * is not open, then -1 is returned.
+ *
+ * @param fd_table the file descriptor table
+ * @param fd the descriptor
+ */
+int fd_table_close(fd_table_t* fd_table, int fd) {
+    const int index = fd - FD_TABLE_FIRST_FD;
+    const int inumber = fd_table_inumber(fd_table, fd);
+
+    if (inumber == -1)
+        return -1;
+
+    /* The following descriptors of the probing cluster are shifted back */
+    /* into the freed slot, such that no tombstone is ever left behind */
+    if (fd_table->slots) {
+        const int mask = fd_table->slot_count - 1;
+        int hole = fd_table_slot(fd_table, inumber);
+        int slot = hole;
+
+        fd_table->slots[hole] = -1;
+        while (fd_table->slots[slot = (slot + 1) & mask] != -1) {
+            const int home = fd_table_home(fd_table, fd_table->files[fd_table->slots[slot] - FD_TABLE_FIRST_FD]);
+
+            /* It checks if the home slot does not lie cyclically in (hole, slot] */
+            if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                fd_table->slots[hole] = fd_table->slots[slot];
+                fd_table->slots[slot] = -1;
+                hole = slot;
+            }
+        }
+    }
+
+    FD_TABLE_FILES(fd_table)[index] = -1;
+    fd_table->size--;
+    if (index < fd_table->first_free)
+        fd_table->first_free = index;
+
+    return inumber;
+}
+
+/**
+ * It returns the inode number the specified
+ * descriptor refers to or -1 if it is closed.
+ *
+ * @param fd_table the file descriptor table
+ * @param fd the descriptor
+ */
+int fd_table_inumber(const fd_table_t* fd_table, int fd) {
+    const int index = fd - FD_TABLE_FIRST_FD;
+
+    if (index < 0 || index >= fd_table->length)
+        return -1;
+
+    return FD_TABLE_FILES(fd_table)[index];
+}
+
+/**
+ * It frees the memory allocated by the
+ * file descriptor table.
+ *
+ * @param fd_table the file descriptor table
+ */
+void fd_table_free(fd_table_t* fd_table) {
+    free(fd_table->files);
+    free(fd_table->slots);
+    fd_table_init(fd_table);
+}
+
+/* Internal File Descriptor Table Function Definitions */
+
+/**
+ * It returns the home slot of the specified inode
+ * number in the hash set, that is, the slot its
+ * probing starts at.
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+static int fd_table_home(const fd_table_t* fd_table, int inumber) {
+    unsigned int hash = (unsigned int) inumber * 2654435761u;
+
+    return (int) ((hash ^ (hash >> 16)) & (fd_table->slot_count - 1));
+}
+
+/**
+ * It returns the slot of the hash set holding the
+ * descriptor of the specified inode number or, if
+ * it has not been opened, the empty slot it would
+ * be stored at (linear probing).
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+static int fd_table_slot(const fd_table_t* fd_table, int inumber) {
+    const int mask = fd_table->slot_count - 1;
+    int slot = fd_table_home(fd_table, inumber);
+
+    while (fd_table->slots[slot] != -1 &&
+           fd_table->files[fd_table->slots[slot] - FD_TABLE_FIRST_FD] != inumber)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+/**
+ * It makes room for one more descriptor, moving the
+ * files to the heap or doubling them. If there is not
+ * enough memory, then the application is exited.
+ *
+ * @param fd_table the file descriptor table
+ */
+static void fd_table_grow(fd_table_t* fd_table) {
+    int* files = (int *)realloc(fd_table->files, 2 * fd_table->capacity * sizeof(int));
+    register int i;
+
+    if (!files) {
+        printf("Not enough memory to allocate the open files of a process.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!fd_table->files)
+        for (i = 0; i < fd_table->length; i++)
+            files[i] = fd_table->inline_files[i];
+
+    fd_table->files = files;
+    fd_table->capacity *= 2;
+}
+
+/**
+ * It rebuilds the hash set with the specified
+ * amount of slots. If there is not enough memory
+ * to allocate them, then the application is exited.
+ *
+ * @param fd_table the file descriptor table
+ * @param slot_count the amount of slots
+ */
+static void fd_table_rehash(fd_table_t* fd_table, int slot_count) {
+    register int i;
+
+    free(fd_table->slots);
+    fd_table->slots = (int *)malloc(slot_count * sizeof(int));
+    fd_table->slot_count = slot_count;
+
+    if (!fd_table->slots) {
+        printf("Not enough memory to allocate the open files of a process.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < slot_count; i++)
+        fd_table->slots[i] = -1;
+
+    for (i = 0; i < fd_table->length; i++)
+        if (fd_table->files[i] != -1)
+            fd_table->slots[fd_table_slot(fd_table, fd_table->files[i])] = i + FD_TABLE_FIRST_FD;
+}
@@ -0,0 +1,127 @@
+#ifndef OS_PROJECT_FD_TABLE_H
+#define OS_PROJECT_FD_TABLE_H
+
+/**
+ * It represents the amount of descriptors a process
+ * may hand out before its descriptor table is indexed
+ * by a hash set. Below it, a linear scan of the files
+ * is faster than hashing.
+ */
+#define FD_TABLE_INLINE (8)
+
+/**
+ * It represents the first descriptor handed out,
+ * since 0, 1 and 2 are the standard streams.
+ */
+#define FD_TABLE_FIRST_FD (3)
+
+/**
+ * It represents the maximum fraction of slots of
+ * the hash set in use, in percent, before it grows.
+ */
+#define FD_TABLE_MAX_LOAD (50)
+
+/**
+ * The file descriptor table of a process. The i-th
+ * descriptor refers to the inode number stored at
+ * files[i - FD_TABLE_FIRST_FD], which is -1 once the
+ * descriptor has been closed. The first descriptors
+ * are stored inside the table itself; once there are
+ * more of them, they are moved to the heap and an
+ * open-addressing hash set maps each inode number
+ * to its descriptor.
+ */
+typedef struct FileDescriptorTable {
+    /**
+     * It holds the inode numbers of the first
+     * descriptors, used while there are few of
+     * them, and the inode numbers of every
+     * descriptor afterwards (otherwise, it is NULL).
+     */
+    int inline_files[FD_TABLE_INLINE];
+    int* files;
+
+    /**
+     * It holds the amount of open files, the
+     * amount of descriptors handed out so far
+     * (open or closed) and the amount of them
+     * the files fit in.
+     */
+    int size;
+    int length;
+    int capacity;
+
+    /**
+     * It holds the lowest closed descriptor
+     * that may be handed out again.
+     */
+    int first_free;
+
+    /**
+     * It holds the slots of the hash set, each of
+     * them holding a descriptor or -1, and their
+     * amount (a power of two). It is NULL while
+     * the files are stored inside the table.
+     */
+    int* slots;
+    int slot_count;
+} fd_table_t;
+
+/* File Descriptor Table Function Prototypes */
+
+/**
+ * It initializes the file descriptor table.
+ *
+ * @param fd_table the file descriptor table
+ */
+void fd_table_init(fd_table_t* fd_table);
+
+/**
+ * It returns the descriptor of the file with the
+ * specified inode number. If the file has not been
+ * opened, then -1 is returned.
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+int fd_table_find(const fd_table_t* fd_table, int inumber);
+
+/**
+ * It opens the file with the specified inode number,
+ * which is supposed not to be open yet, and it returns
+ * its descriptor (the lowest one not taken). If there
+ * is not enough memory, then the application is exited.
+ *
+ * @param fd_table the file descriptor table
+ * @param inumber the inode number
+ */
+int fd_table_open(fd_table_t* fd_table, int inumber);
+
+/**
+ * It closes the specified descriptor and it returns
+ * the inode number it referred to. If the descriptor
+ * is not open, then -1 is returned.
+ *
+ * @param fd_table the file descriptor table
+ * @param fd the descriptor
+ */
+int fd_table_close(fd_table_t* fd_table, int fd);
+
+/**
+ * It returns the inode number the specified
+ * descriptor refers to or -1 if it is closed.
+ *
+ * @param fd_table the file descriptor table
+ * @param fd the descriptor
+ */
+int fd_table_inumber(const fd_table_t* fd_table, int fd);
+
+/**
+ * It frees the memory allocated by the
+ * file descriptor table.
+ *
+ * @param fd_table the file descriptor table
+ */
+void fd_table_free(fd_table_t* fd_table);
+
+#endif // OS_PROJECT_FD_TABLE_H
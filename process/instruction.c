@@ -17,10 +17,9 @@
  * @param sem_table a pointer to a semaphore table
  */
 void instr_semaphore_parse(instr_t* instr, const char* line, semaphore_table_t* sem_table) {
-    char* sem_name = strdup(line);
+    char* sem_name = strdup(line + 2); /* jump P( or V( */
     semaphore_t* sem;
 
-    sem_name = sem_name + 2; /* jump P( or V( */
     sem_name[strlen(sem_name) - 2] = '\0';
 
     sem = semaphore_find(sem_table, sem_name);
@@ -34,6 +33,7 @@ void instr_semaphore_parse(instr_t* instr, const char* line, semaphore_table_t*
 
     instr->op = line[0] == 'P' ? SEM_P : SEM_V;
     instr->sem = sem_name;
+    instr->path = NULL;
 }
 
 /* Instruction Function Definitions  */
@@ -57,8 +57,9 @@ void instr_parse(instr_t* instr, const char* line, semaphore_table_t* sem_table)
     /* Binary instruction */
     else {
         char* dupline = strdup(line);
-        char* left_op = strtok(dupline, " ");
-        int right_op = atoi(strtok(NULL, " "));
+        char* left_op = strtok(dupline, " \r\n");
+        char* right_tok = strtok(NULL, " \r\n");
+        int right_op = right_tok ? atoi(right_tok) : 0;
 
         if (strcmp(left_op, "exec") == 0)
             instr->op = EXEC;
@@ -68,8 +69,36 @@ void instr_parse(instr_t* instr, const char* line, semaphore_table_t* sem_table)
             instr->op = WRITE;
         else if (strcmp(left_op, "print") == 0)
             instr->op = PRINT;
+        else if (strcmp(left_op, "sync") == 0)
+            instr->op = SYNC;
+        else if (strcmp(left_op, "aread") == 0)
+            instr->op = AREAD;
+        else if (strcmp(left_op, "await") == 0)
+            instr->op = AWAIT;
+        else if (strcmp(left_op, "open") == 0)
+            instr->op = OPEN;
+        else if (strcmp(left_op, "create") == 0)
+            instr->op = CREAT;
+        else if (strcmp(left_op, "close") == 0)
+            instr->op = CLOSE;
 
         instr->value = right_op;
         instr->sem = NULL;
+        instr->path = (instr->op == OPEN || instr->op == CREAT) && right_tok ? strdup(right_tok) : NULL;
+
+        free(dupline);
     }
 }
+
+/**
+ * It frees the semaphore name and the path
+ * held by the specified instruction.
+ *
+ * @param instr a pointer to an instruction
+ */
+void instr_free(instr_t* instr) {
+    free(instr->sem);
+    free(instr->path);
+    instr->sem = NULL;
+    instr->path = NULL;
+}
@@ -13,24 +13,32 @@ typedef enum Opcode {
     WRITE,
     PRINT,
     SEM_P,
-    SEM_V
+    SEM_V,
+    SYNC,
+    AREAD,
+    AWAIT,
+    OPEN,
+    CREAT,
+    CLOSE
 } opcode_t;
 
 /**
  * It represents an instruction that contains
  * an operator, a possible value and may contain
- * a semaphore that has been requested.
+ * a semaphore that has been requested or a path.
  *
  * The general instruction's format is:
  *  - For unary operators
  *    <left_op(semaphore_name)>
  *  - For binary operators
  *    <left_op> <value>
+ *    <left_op> <path>
  */
 typedef struct Instruction {
     opcode_t op;
     int value;
     char* sem;
+    char* path;
 } instr_t;
 
 /* Instruction Function Prototypes */
@@ -49,4 +57,12 @@ typedef struct Instruction {
  */
 void instr_parse(instr_t* instr, const char* line, semaphore_table_t* sem_table);
 
+/**
+ * It frees the semaphore name and the path
+ * held by the specified instruction.
+ *
+ * @param instr a pointer to an instruction
+ */
+void instr_free(instr_t* instr);
+
 #endif // SO_PROJECT_INSTRUCTION_H
@@ -1,10 +1,17 @@
 #include "../tools/constants.h"
+#include "../tools/slab.h"
 #include "process.h"
 
 #include <string.h>
 
 #define BUF_LEN_PARSE (256)
 
+/**
+ * The slab cache from which the
+ * processes are allocated.
+ */
+static slab_cache_t process_cache = SLAB_CACHE_INITIALIZER("process", process_t);
+
 #ifndef OS_SCHED_KERNEL
 #define OS_SCHED_KERNEL
 #include "../kernel/kernel.h"
@@ -61,6 +68,16 @@ static process_t* parse_synthetic_program(FILE* fp, char* buf);
  */
 static void read_semaphores(process_t* proc, char* sem_line);
 
+/**
+ * It parses the I/O class that may follow the
+ * process priority, that is, rt (realtime), be
+ * (best-effort) or idle. If there is none, then
+ * the process is best-effort.
+ *
+ * @param priority_line the process priority line
+ */
+static disk_ioclass_t parse_ioclass(char* priority_line);
+
 /* Process Function Definition */
 
 /**
@@ -76,6 +93,7 @@ void process_create(const char* filepath) {
     process_t* proc;
     instr_t *code;
     char buf[BUF_LEN_PARSE];
+    int i;
 
     /* It checks if the file could not be opened */
     if (!(fp = fopen(filepath, "r"))) {
@@ -94,6 +112,12 @@ void process_create(const char* filepath) {
 
     sysCall(MEM_LOAD_REQ, (void *) &memory_request);
 
+    /* The code has been copied into a (possibly shared) code */
+    /* image, therefore, the parsed code is no longer needed */
+    for (i = 0; i < proc->code_len; i++)
+        instr_free(&code[i]);
+    free(code);
+
     LOG_PROC_A("Process %s (%d) added into the process table.\n", proc->name, proc->id);
 }
 
@@ -110,15 +134,18 @@ void process_finish(process_t* proc) {
         /* Remove the node from the PCB */
         list_node_t* pcb_proc_node = list_search(kernel->proc_table, proc, proc_cmp);
         list_remove_node(kernel->proc_table, pcb_proc_node);
+        list_node_free(pcb_proc_node);
 
         /* If the process is running, then interrupt it */
         if (proc_cmp(kernel->scheduler.scheduled_proc, proc))
             sysCall(PROCESS_INTERRUPT, (void *) NONE);
 
         /* Decrement the process count in the open files */
-        FOREACH(proc->o_files, int) {
-            fs_close_request(&kernel->file_table, proc, it);
-        }
+        int fd;
+
+        for (fd = FD_TABLE_FIRST_FD; fd < proc->o_files.length + FD_TABLE_FIRST_FD; fd++)
+            if (fd_table_inumber(&proc->o_files, fd) != -1)
+                fs_close_request(&kernel->file_table, proc, fd_table_inumber(&proc->o_files, fd));
 
         segment_free(&kernel->seg_table, proc->seg_id);
 
@@ -131,13 +158,15 @@ void process_finish(process_t* proc) {
             list_remove_node(kernel->scheduler.low_queue->queue, sched_proc_node);
         else if ((sched_proc_node = list_search(kernel->scheduler.blocked_queue->queue, proc, proc_cmp)))
             list_remove_node(kernel->scheduler.blocked_queue->queue, sched_proc_node);
+        list_node_free(sched_proc_node);
 
         LOG_PROC_A("Process %s has been finished.\n", proc->name);
 
         /* It frees the process allocated memory */
         free(proc->name);
         free(proc->semaphores);
-        free(proc);
+        fd_table_free(&proc->o_files);
+        slab_free(&process_cache, proc);
     }
 }
 
@@ -167,7 +196,7 @@ int proc_cmp(void* p1, void *p2) {
  * @param filepath the filepath
  */
 static process_t* parse_synthetic_program(FILE* fp, char* buf) {
-    process_t *proc = (process_t *)malloc(sizeof(process_t));
+    process_t *proc = (process_t *)slab_alloc(&process_cache);
 
     /* It checks if the process could not be allocated */
     if (!proc) {
@@ -181,7 +210,13 @@ static process_t* parse_synthetic_program(FILE* fp, char* buf) {
     proc->pc = 0;
     proc->state = NEW;
     proc->remaining = 0;
-    proc->o_files = list_init();
+    fd_table_init(&proc->o_files);
+    proc->semaphores = NULL;
+    proc->last_read = -1;
+    proc->ra_window = 0;
+    proc->ra_next = 0;
+    proc->aio_pending = 0;
+    proc->aio_waiting = 0;
 
     /* Dependent file information */
     fgets(buf, BUF_LEN_PARSE, fp);
@@ -193,6 +228,7 @@ static process_t* parse_synthetic_program(FILE* fp, char* buf) {
 
     fgets(buf, BUF_LEN_PARSE, fp);
     proc->priority = atoi(buf);
+    proc->ioclass = parse_ioclass(buf);
 
     fgets(buf, BUF_LEN_PARSE, fp);
     proc->seg_size = atoi(buf);
@@ -260,9 +296,24 @@ static instr_t* read_code(char* buf, FILE *fp, int *code_len) {
         if ((0 == strcmp(buf, "\n")) || (0 == strcmp(buf, "\r\n")))
           continue;
 
-        instr_parse(&code[i++], buf, &kernel->sem_table);
+        instr_parse(&code[i], buf, &kernel->sem_table);
+
+        /* It checks if the instruction refers to a track the disk */
+        /* does not have, since the track indexes the disk queues, */
+        /* the buffer cache and the file system inodes */
+        if ((code[i].op == READ || code[i].op == WRITE || code[i].op == AREAD)
+            && (code[i].value < 0 || code[i].value > DISK_TRACK_LIMIT)) {
+            printf("The track %d is out of the disk, whose tracks are 0 to %d.\n",
+                   code[i].value, DISK_TRACK_LIMIT);
+            exit(EXIT_FAILURE);
+        }
+
+        i++;
     }
 
+    /* The blank lines have been counted but not parsed */
+    (*code_len) = i;
+
     return code;
 }
 
@@ -326,10 +377,28 @@ static void read_semaphores(process_t* proc, char* sem_line) {
  *            Otherwise, 0 is returned.
  */
 int has_opened_file(process_t* process, int inumber) {
-    FOREACH(process->o_files, int) {
-        if (it == inumber)
-            return 1;
-    }
+    return fd_table_find(&process->o_files, inumber) != -1;
+}
 
-    return 0;
+/**
+ * It parses the I/O class that may follow the
+ * process priority, that is, rt (realtime), be
+ * (best-effort) or idle. If there is none, then
+ * the process is best-effort.
+ *
+ * @param priority_line the process priority line
+ */
+static disk_ioclass_t parse_ioclass(char* priority_line) {
+    char* ioclass;
+
+    strtok(priority_line, " \r\n");
+    if (!(ioclass = strtok(NULL, " \r\n")) || strcmp(ioclass, "be") == 0)
+        return DISK_IOCLASS_BE;
+    if (strcmp(ioclass, "rt") == 0)
+        return DISK_IOCLASS_RT;
+    if (strcmp(ioclass, "idle") == 0)
+        return DISK_IOCLASS_IDLE;
+
+    printf("The I/O class %s is not available.\n", ioclass);
+    exit(EXIT_FAILURE);
 }
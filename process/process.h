@@ -4,6 +4,8 @@
 #include <stdio.h>
 
 #include "../tools/list.h"
+#include "../disk/ioclass.h"
+#include "fd_table.h"
 
 #define FETCH_INSTR_ADDR(x) ((x)->pc++)
 
@@ -28,19 +30,46 @@ typedef struct Process {
 
     /* Scheduling Information */
     int priority;
+
+    /**
+     * It holds the I/O class the disk
+     * requests of the process are served
+     * in.
+     */
+    disk_ioclass_t ioclass;
     int remaining;
     process_state_t state;
 
     /**
-     * It represents an array of open
-     * files by this process. This vector
-     * contains the inode's number from
-     * the active inodes by this process.
+     * It represents the files opened by
+     * this process, that is, a descriptor
+     * for each inode's number from the
+     * active inodes by this process.
      */
-    list_t* o_files;
+    fd_table_t o_files;
 
     /* Resource Acquisition Information */
     char **semaphores;
+
+    /* Read-Ahead Information */
+    /**
+     * It holds the last track read, the
+     * amount of tracks currently read ahead
+     * (it grows while the reads are sequential)
+     * and the next track not read ahead yet.
+     */
+    int last_read;
+    int ra_window;
+    int ra_next;
+
+    /* Asynchronous I/O Information */
+    /**
+     * It holds the amount of asynchronous reads
+     * not completed yet and whether the process
+     * is blocked until all of them complete.
+     */
+    int aio_pending;
+    int aio_waiting;
 } process_t;
 
 /* Process Function Prototype */
@@ -50,13 +50,18 @@ void scheduler_init(scheduler_t* scheduler) {
 void schedule_process(scheduler_t* scheduler, scheduler_flag_t flags) {
     process_t* curr_scheduled = scheduler->scheduled_proc;
     process_t* new_scheduled = NULL;
+    list_node_t* head;
 
     if (!list_empty(scheduler->high_queue->queue)) {
-        new_scheduled = (process_t *)list_remove_head(scheduler->high_queue->queue)->content;
+        head = list_remove_head(scheduler->high_queue->queue);
+        new_scheduled = (process_t *)head->content;
+        list_node_free(head);
         if (new_scheduled)
             new_scheduled->remaining = MAX(1000, MIN(SCHED_HIGH_QUEUE_QUANTUM, new_scheduled->remaining + scheduler->high_queue->quantum));
     } else if (!list_empty(scheduler->low_queue->queue)) {
-        new_scheduled = (process_t *)list_remove_head(scheduler->low_queue->queue)->content;
+        head = list_remove_head(scheduler->low_queue->queue);
+        new_scheduled = (process_t *)head->content;
+        list_node_free(head);
         if (new_scheduled)
             new_scheduled->remaining = MAX(0, MIN(SCHED_LOW_QUEUE_QUANTUM, new_scheduled->remaining + scheduler->low_queue->quantum));
     }
@@ -96,6 +101,7 @@ void schedule_unblock_process(scheduler_t* scheduler, process_t* proc, scheduler
         return;
 
     list_remove_node(scheduler->blocked_queue->queue, proc_node);
+    list_node_free(proc_node);
 
     switch (queue_flag) {
         case HIGH_QUEUE: {
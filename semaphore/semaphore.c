@@ -143,7 +143,10 @@ void semaphore_V(semaphore_t *sem, process_t *process, void (*wakeup)(process_t
     sem_wait(&sem->mutex);
     sem->S++;
     if (sem->S <= 0) {
-        process_t* proc = list_remove_head(sem->waiters)->content;
+        list_node_t* waiter = list_remove_head(sem->waiters);
+        process_t* proc = waiter->content;
+
+        list_node_free(waiter);
         wakeup(proc);
     }
 
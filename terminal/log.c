@@ -3,6 +3,19 @@
 #include <string.h>
 
 #include "log.h"
+#include "../tools/slab.h"
+
+/**
+ * The slab caches from which the
+ * log records are allocated.
+ */
+static slab_cache_t proc_log_cache = SLAB_CACHE_INITIALIZER("proc_log", proc_log_info_t);
+static slab_cache_t disk_log_cache = SLAB_CACHE_INITIALIZER("disk_log", disk_log_info_t);
+static slab_cache_t io_log_cache = SLAB_CACHE_INITIALIZER("io_log", io_log_info_t);
+static slab_cache_t io_fs_log_cache = SLAB_CACHE_INITIALIZER("io_fs_log", io_log_fs_t);
+static slab_cache_t io_disk_log_cache = SLAB_CACHE_INITIALIZER("io_disk_log", io_log_disk_req_t);
+static slab_cache_t io_print_log_cache = SLAB_CACHE_INITIALIZER("io_print_log", io_log_print_t);
+static slab_cache_t res_acq_log_cache = SLAB_CACHE_INITIALIZER("res_acq_log", res_acq_log_t);
 
 /* Process Log Related Function Definitions */
 
@@ -24,7 +37,7 @@ void process_log_init() {
  * the log operation.
  */
 void process_log(const char* process_name, const int remaining, const int pc, const int sid, const int f_op_count) {
-    proc_log_info_t* log = (proc_log_info_t *)malloc(sizeof(proc_log_info_t));
+    proc_log_info_t* log = (proc_log_info_t *)slab_alloc(&proc_log_cache);
 
     /* It checks if the process log could not be allocated */
     if (!log) {
@@ -55,7 +68,7 @@ void process_log(const char* process_name, const int remaining, const int pc, co
  * the log operation.
  */
 void process_np_log() {
-    proc_log_info_t* log = (proc_log_info_t *)malloc(sizeof(proc_log_info_t));
+    proc_log_info_t* log = (proc_log_info_t *)slab_alloc(&proc_log_cache);
 
     /* It checks if the process log could not be allocated */
     if (!log) {
@@ -101,7 +114,7 @@ void disk_log_init() {
  */
 void disk_log(const char* process_name, const int proc_id,
               const int track, const int read, const int turnaround) {
-    disk_log_info_t* log = (disk_log_info_t *)malloc(sizeof(disk_log_info_t));
+    disk_log_info_t* log = (disk_log_info_t *)slab_alloc(&disk_log_cache);
 
     /* It checks if the disk log could not be allocated */
     if (!log) {
@@ -156,7 +169,7 @@ void io_log_init() {
  * the log operation.
  */
 void io_fs_log(const char* process_name, const int inumber, const io_log_fs_flag_t opt) {
-    io_log_info_t* log = (io_log_info_t *)malloc(sizeof(io_log_info_t));
+    io_log_info_t* log = (io_log_info_t *)slab_alloc(&io_log_cache);
 
     /* It checks if the I/O log could not be allocated */
     if (!log) {
@@ -164,7 +177,7 @@ void io_fs_log(const char* process_name, const int inumber, const io_log_fs_flag
         exit(EXIT_FAILURE);
     }
 
-    log->fs_log = (io_log_fs_t *)malloc(sizeof(io_log_fs_t));
+    log->fs_log = (io_log_fs_t *)slab_alloc(&io_fs_log_cache);
 
     /* It checks if the I/O file system log could not be allocated */
     if (!log->fs_log) {
@@ -197,7 +210,7 @@ void io_fs_log(const char* process_name, const int inumber, const io_log_fs_flag
  * the log operation.
  */
 void io_disk_log(const char* process_name, const int read) {
-    io_log_info_t* log = (io_log_info_t *)malloc(sizeof(io_log_info_t));
+    io_log_info_t* log = (io_log_info_t *)slab_alloc(&io_log_cache);
 
     /* It checks if the I/O log could not be allocated */
     if (!log) {
@@ -205,7 +218,7 @@ void io_disk_log(const char* process_name, const int read) {
         exit(EXIT_FAILURE);
     }
 
-    log->disk_req_log = (io_log_disk_req_t *)malloc(sizeof(io_log_disk_req_t));
+    log->disk_req_log = (io_log_disk_req_t *)slab_alloc(&io_disk_log_cache);
 
     /* It checks if the I/O disk log could not be allocated */
     if (!log->disk_req_log) {
@@ -231,7 +244,7 @@ void io_disk_log(const char* process_name, const int read) {
  * the log operation.
  */
 void io_print_log(const char* process_name, const int duration) {
-    io_log_info_t* log = (io_log_info_t *)malloc(sizeof(io_log_info_t));
+    io_log_info_t* log = (io_log_info_t *)slab_alloc(&io_log_cache);
 
     /* It checks if the I/O log could not be allocated */
     if (!log) {
@@ -239,7 +252,7 @@ void io_print_log(const char* process_name, const int duration) {
         exit(EXIT_FAILURE);
     }
 
-    log->print_log = (io_log_print_t *)malloc(sizeof(io_log_print_t));
+    log->print_log = (io_log_print_t *)slab_alloc(&io_print_log_cache);
 
     /* It checks if the I/O print log could not be allocated */
     if (!log->print_log) {
@@ -280,7 +293,7 @@ void res_acq_log_init() {
  * the log operation.
  */
 void res_acq_log(const char* process_name, const char* sem_name, const int acq, const int blocked) {
-    res_acq_log_t* log = (res_acq_log_t *)malloc(sizeof(res_acq_log_t));
+    res_acq_log_t* log = (res_acq_log_t *)slab_alloc(&res_acq_log_cache);
 
     /* It checks if the resource acquisition/release could not be allocated */
     if (!log) {
@@ -775,12 +775,17 @@ _Noreturn void* refresh_io_log() {
  */
 FWIN_REFRESH_TITLE(memory) {
     const char title[] = "Memory View";
-    const int wlen = sprintf(win_mem->buffer_rs, "LSS: %d Kbytes Use: %.1lf%%", max_seg_size() >> 10,
-                             (1.0 - (double) kernel->seg_table.remaining / GIGABYTE) * 100.0);
+    buddy_stats_t stats;
+
+    buddy_stats(&kernel->seg_table.buddy, &stats);
+    const int wlen = sprintf(win_mem->buffer_rs, "LSS: %d Kbytes Use: %.1lf%% EF: %.1lf%%", max_seg_size() >> 10,
+                             (1.0 - (double) kernel->seg_table.remaining / GIGABYTE) * 100.0,
+                             stats.external_frag * 100.0);
 
     wclear(win_mem->win.title_window);
     wattron(win_mem->win.title_window, COLOR_PAIR(1) | A_BOLD);
-    mvwprintw(win_mem->win.title_window, 1, 1, "Remaining: %d Kbytes", kernel->seg_table.remaining >> 10);
+    mvwprintw(win_mem->win.title_window, 1, 1, "Remaining: %d Kbytes PF: %ld", kernel->seg_table.remaining >> 10,
+              kernel->seg_table.fault_count);
     mvwprintw(win_mem->win.title_window, 1, (COLS >> 1) - wlen - (BOX_SIZE >> 1), "%s", win_mem->buffer_rs);
     wattron(win_mem->win.title_window, COLOR_PAIR(3));
 
@@ -858,10 +863,11 @@ FWIN_REFRESH(memory) {
  */
 FWIN_REFRESH_TITLE(disk) {
     const char title[] = "Disk View";
-    const int wlen = sprintf(win_disk->buffer_rs, "AngV: %d rpm R: %d W: %d",
+    const int wlen = sprintf(win_disk->buffer_rs, "AngV: %d rpm R: %d W: %d HR: %.1lf%%",
                              disk_general_log->angular_v,
                              disk_general_log->r_req_count,
-                             disk_general_log->w_req_count);
+                             disk_general_log->w_req_count,
+                             buffer_cache_hit_ratio(&kernel->buffer_cache) * 100.0);
 
     /* It clears the title window to write the (possibly updated) information */
     wclear(win_disk->win.title_window);
@@ -871,10 +877,14 @@ FWIN_REFRESH_TITLE(disk) {
 
     /* It prints the related disk information on the left side of the disk view */
     /* title. In this case, the direction, track and amount of pending requests */
-    /* for disk operation is being shown. */
-    wprintw(win_disk->win.title_window, "DIR: %s Track: %d Requests: %d",
+    /* for disk operation is being shown, together with the hottest track and */
+    /* the 99-th percentile latency of the reads and of the writes. */
+    wprintw(win_disk->win.title_window, "DIR: %s Track: %d Requests: %d Hot: %d P99 R/W: %ld/%ld",
             disk_general_log->forward_dir ? "F" : "B",
-            disk_general_log->curr_track, disk_general_log->pending_requests_size);
+            disk_general_log->curr_track, disk_general_log->pending_requests_size,
+            volume_hottest_track(&kernel->volume),
+            histogram_percentile(&kernel->volume.latency[1][VOLUME_LATENCY_TOTAL], 99.0),
+            histogram_percentile(&kernel->volume.latency[0][VOLUME_LATENCY_TOTAL], 99.0));
 
     /* It prints the related disk information on the right side of the disk view */
     /* title. In this case, the disk's current angular velocity, the amount of */
@@ -0,0 +1,173 @@
+/**
+ * It measures the lookup and the open/close churn
+ * of the active inodes, both under the inode table
+ * (see file/inode_table.h) and under the inode list
+ * it has replaced, for growing amounts of inodes.
+ *
+ * Build and run it with: make bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../disk/disk.h"
+#include "../../file/file.h"
+
+/**
+ * It represents the amount of lookups and of
+ * open/close pairs measured for each amount of
+ * inodes. The list is measured on fewer of them
+ * as it gets longer, such that it ends in time.
+ */
+#define BENCH_OPERATIONS (1000000)
+#define BENCH_LIST_BUDGET (400000000L)
+
+/* Inode List Functions (the replaced version) */
+
+/**
+ * It returns the inode of the specified inode
+ * number by scanning the inode list or NULL if
+ * it is not in the list.
+ *
+ * @param inode_list the inode list
+ * @param inumber the inode number
+ */
+static inode_t* list_find(list_t* inode_list, int inumber) {
+    FOREACH(inode_list, inode_t*) {
+        if (it->id == inumber)
+            return it;
+    }
+
+    return NULL;
+}
+
+/**
+ * It removes the inode of the specified inode
+ * number from the inode list and it returns it
+ * or NULL if it is not in the list.
+ *
+ * @param inode_list the inode list
+ * @param inumber the inode number
+ */
+static inode_t* list_remove_inode(list_t* inode_list, int inumber) {
+    FOREACH(inode_list, inode_t*) {
+        if (it->id == inumber) {
+            list_remove_node(inode_list, curr_node);
+            list_node_free(curr_node);
+            return it;
+        }
+    }
+
+    return NULL;
+}
+
+/* Benchmark Functions */
+
+/**
+ * It returns the monotonic time (ns).
+ */
+static double bench_now() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/**
+ * It returns the inode number of the i-th
+ * active inode, as the file system does.
+ *
+ * @param i the index of the active inode
+ */
+static int bench_inumber(int i) {
+    return INODE_NUMBER(DISK_BLOCK(i));
+}
+
+/**
+ * It measures the lookups and the open/close
+ * pairs over the specified amount of active
+ * inodes, both under the inode list and under
+ * the inode table, and it prints a row of the
+ * mean time (ns) of each of them.
+ *
+ * @param count the amount of active inodes
+ */
+static void bench_run(int count) {
+    inode_t* inodes = (inode_t *)calloc(count, sizeof(inode_t));
+    const long list_ops = BENCH_LIST_BUDGET / count < BENCH_OPERATIONS
+                          ? BENCH_LIST_BUDGET / count : BENCH_OPERATIONS;
+    list_t* inode_list = list_init();
+    itable_t itable;
+    double list_lookup, table_lookup, list_churn, table_churn, start;
+    long found = 0;
+    long i;
+
+    if (!inodes) {
+        printf("Not enough memory to allocate the benchmark inodes.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    itable_init(&itable);
+    for (i = 0; i < count; i++) {
+        inodes[i].id = bench_inumber((int) i);
+        list_add(inode_list, &inodes[i]);
+        itable_insert(&itable, &inodes[i]);
+    }
+
+    srand(count);
+    start = bench_now();
+    for (i = 0; i < list_ops; i++)
+        found += list_find(inode_list, bench_inumber(rand() % count)) != NULL;
+    list_lookup = (bench_now() - start) / list_ops;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_OPERATIONS; i++)
+        found += itable_find(&itable, bench_inumber(rand() % count)) != NULL;
+    table_lookup = (bench_now() - start) / BENCH_OPERATIONS;
+
+    /* Each close of an inode is followed by its reopening */
+    start = bench_now();
+    for (i = 0; i < list_ops; i++) {
+        inode_t* inode = list_remove_inode(inode_list, bench_inumber(rand() % count));
+        list_add(inode_list, inode);
+    }
+    list_churn = (bench_now() - start) / list_ops;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_OPERATIONS; i++) {
+        inode_t* inode = itable_remove(&itable, bench_inumber(rand() % count));
+        itable_insert(&itable, inode);
+    }
+    table_churn = (bench_now() - start) / BENCH_OPERATIONS;
+
+    /* Every looked up inode must have been found */
+    if (found != list_ops + BENCH_OPERATIONS || itable.size != count) {
+        printf("The inode table has lost some inode.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%8d %14.1lf %14.1lf %8.1lfx %14.1lf %14.1lf %8.1lfx\n", count,
+           list_lookup, table_lookup, list_lookup / table_lookup,
+           list_churn, table_churn, list_churn / table_churn);
+
+    list_free(inode_list);
+    free(itable.slots);
+    free(inodes);
+}
+
+/**
+ * It prints the benchmark table, one row
+ * for each amount of active inodes.
+ */
+int main() {
+    static const int counts[] = { 16, 256, 4096, 16384, 65536 };
+    register int i;
+
+    printf("%8s %14s %14s %9s %14s %14s %9s\n", "Inodes", "ListLookupNs", "TableLookupNs",
+           "Speedup", "ListChurnNs", "TableChurnNs", "Speedup");
+    for (i = 0; i < (int) (sizeof(counts) / sizeof(counts[0])); i++)
+        bench_run(counts[i]);
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "histogram.h"
+
+/* Internal Histogram Function Prototypes */
+
+/**
+ * It returns the bucket the specified value is recorded
+ * in. The values lower than HISTOGRAM_SUB_BUCKETS have a
+ * bucket each, whereas the others share a bucket with
+ * those having the same leading bits.
+ *
+ * @param value the (non-negative) value
+ */
+static int histogram_bucket(long value);
+
+/**
+ * It returns the highest value recorded
+ * in the specified bucket.
+ *
+ * @param bucket the bucket
+ */
+static long histogram_bucket_max(int bucket);
+
+/* Histogram Function Definitions */
+
+/**
+ * It initializes the histogram.
+ *
+ * @param histogram the histogram
+ */
+void histogram_init(histogram_t* histogram) {
+    register int i;
+
+    for (i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+        histogram->counts[i] = 0;
+
+    histogram->count = 0;
+    histogram->sum = 0;
+    histogram->max = 0;
+}
+
+/**
+ * It records the specified value. A negative
+ * value is recorded as zero.
+ *
+ * @param histogram the histogram
+ * @param value the value
+ */
+void histogram_record(histogram_t* histogram, long value) {
+    long max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+
+    if (value < 0)
+        value = 0;
+
+    __atomic_fetch_add(&histogram->counts[histogram_bucket(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, value, __ATOMIC_RELAXED);
+
+    /* The maximum is only replaced by a larger value */
+    while (value > max && !__atomic_compare_exchange_n(&histogram->max, &max, value, 0,
+                                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ * It returns the value below which the specified
+ * percentage of the recorded values lies, that is,
+ * the highest value of the bucket holding it. If
+ * no value has been recorded, then 0 is returned.
+ *
+ * @param histogram the histogram
+ * @param percentile the percentage (0 to 100)
+ */
+long histogram_percentile(const histogram_t* histogram, double percentile) {
+    const long count = __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+    const long rank = (long) (percentile / 100.0 * count + 0.5);
+    long seen = 0;
+    register int i;
+
+    if (count == 0)
+        return 0;
+
+    for (i = 0; i < HISTOGRAM_BUCKET_COUNT; i++)
+        if ((seen += __atomic_load_n(&histogram->counts[i], __ATOMIC_RELAXED)) >= (rank > 0 ? rank : 1))
+            break;
+
+    /* The bucket bound never exceeds the largest recorded value */
+    if (i == HISTOGRAM_BUCKET_COUNT || histogram_bucket_max(i) > histogram->max)
+        return histogram->max;
+    return histogram_bucket_max(i);
+}
+
+/**
+ * It returns the mean of the recorded values.
+ *
+ * @param histogram the histogram
+ */
+double histogram_mean(const histogram_t* histogram) {
+    return histogram->count > 0 ? (double) histogram->sum / histogram->count : 0.0;
+}
+
+/**
+ * It prints the amount, the mean, the median, the
+ * tail percentiles and the maximum of the recorded
+ * values in a single line.
+ *
+ * @param histogram the histogram
+ * @param name the histogram name
+ * @param fp the file to be printed to
+ */
+void histogram_print(const histogram_t* histogram, const char* name, FILE* fp) {
+    fprintf(fp, "%-14s %8ld %10.1lf %8ld %8ld %8ld %8ld %8ld\n", name, histogram->count,
+            histogram_mean(histogram), histogram_percentile(histogram, 50.0),
+            histogram_percentile(histogram, 90.0), histogram_percentile(histogram, 99.0),
+            histogram_percentile(histogram, 99.9), histogram->max);
+}
+
+/* Internal Histogram Function Definitions */
+
+/**
+ * It returns the bucket the specified value is recorded
+ * in. The values lower than HISTOGRAM_SUB_BUCKETS have a
+ * bucket each, whereas the others share a bucket with
+ * those having the same leading bits.
+ *
+ * @param value the (non-negative) value
+ */
+static int histogram_bucket(long value) {
+    int msb;
+
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return (int) value;
+
+    msb = 63 - __builtin_clzl((unsigned long) value);
+    return (msb - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS
+           + (int) ((value >> (msb - HISTOGRAM_SUB_BUCKET_BITS)) - HISTOGRAM_SUB_BUCKETS);
+}
+
+/**
+ * It returns the highest value recorded
+ * in the specified bucket.
+ *
+ * @param bucket the bucket
+ */
+static long histogram_bucket_max(int bucket) {
+    int shift;
+
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return bucket;
+
+    shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    return (((long) (bucket % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS) + 1) << shift) - 1;
+}
@@ -0,0 +1,91 @@
+#ifndef OS_PROJECT_HISTOGRAM_H
+#define OS_PROJECT_HISTOGRAM_H
+
+#include <stdio.h>
+
+/**
+ * It represents the amount of bits of a value kept
+ * below its most significant one, such that each
+ * power of two is split into equally sized buckets
+ * and every value is recorded within 1/16 of it.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS (4)
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * It represents the amount of buckets, that is,
+ * enough to hold any non-negative long value.
+ */
+#define HISTOGRAM_BUCKET_COUNT ((64 - HISTOGRAM_SUB_BUCKET_BITS) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * A histogram of non-negative values whose buckets
+ * grow exponentially in width (as in HDR histograms),
+ * such that the values are recorded with a bounded
+ * relative error in constant space. The values may be
+ * recorded by several threads at once.
+ */
+typedef struct Histogram {
+    /**
+     * It holds the amount of values
+     * recorded in each bucket.
+     */
+    long counts[HISTOGRAM_BUCKET_COUNT];
+
+    /**
+     * It holds the amount of recorded values,
+     * their sum and the largest of them.
+     */
+    long count;
+    long sum;
+    long max;
+} histogram_t;
+
+/* Histogram Function Prototypes */
+
+/**
+ * It initializes the histogram.
+ *
+ * @param histogram the histogram
+ */
+void histogram_init(histogram_t* histogram);
+
+/**
+ * It records the specified value. A negative
+ * value is recorded as zero.
+ *
+ * @param histogram the histogram
+ * @param value the value
+ */
+void histogram_record(histogram_t* histogram, long value);
+
+/**
+ * It returns the value below which the specified
+ * percentage of the recorded values lies, that is,
+ * the highest value of the bucket holding it. If
+ * no value has been recorded, then 0 is returned.
+ *
+ * @param histogram the histogram
+ * @param percentile the percentage (0 to 100)
+ */
+long histogram_percentile(const histogram_t* histogram, double percentile);
+
+/**
+ * It returns the mean of the recorded values.
+ *
+ * @param histogram the histogram
+ */
+double histogram_mean(const histogram_t* histogram);
+
+/**
+ * It prints the amount, the mean, the median, the
+ * tail percentiles and the maximum of the recorded
+ * values in a single line.
+ *
+ * @param histogram the histogram
+ * @param name the histogram name
+ * @param fp the file to be printed to
+ */
+void histogram_print(const histogram_t* histogram, const char* name, FILE* fp);
+
+#endif // OS_PROJECT_HISTOGRAM_H
@@ -2,6 +2,13 @@
 #include <stdlib.h>
 
 #include "list.h"
+#include "slab.h"
+
+/**
+ * The slab cache from which the
+ * list nodes are allocated.
+ */
+static slab_cache_t list_node_cache = SLAB_CACHE_INITIALIZER("list_node", list_node_t);
 
 /* List Node Functions */
 
@@ -18,8 +25,7 @@
  *         NULL (not enough memory)
  */
 list_node_t *list_node_create(void *content) {
-    register int i;
-    list_node_t *node = (list_node_t *)malloc(sizeof(list_node_t));
+    list_node_t *node = (list_node_t *)slab_alloc(&list_node_cache);
 
     /* It checks if the node has not been allocated */
     if (!node) {
@@ -34,6 +40,17 @@ list_node_t *list_node_create(void *content) {
     return node;
 }
 
+/**
+ * It releases the memory allocated to
+ * the node. The node must have been
+ * already removed from its list.
+ *
+ * @param node the node to be freed
+ */
+void list_node_free(list_node_t *node) {
+    slab_free(&list_node_cache, node);
+}
+
 /* List Functions */
 
 /**
@@ -200,7 +217,7 @@ void list_free(list_t *list) {
 
         while (curr) {
             temp = curr->next;
-            free(curr);
+            list_node_free(curr);
             curr = temp;
         }
 
@@ -67,6 +67,15 @@ typedef struct List {
  */
 list_node_t *list_node_create(void *content);
 
+/**
+ * It releases the memory allocated to
+ * the node. The node must have been
+ * already removed from its list.
+ *
+ * @param node the node to be freed
+ */
+void list_node_free(list_node_t *node);
+
 /* List Prototypes */
 
 /**
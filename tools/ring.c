@@ -0,0 +1,107 @@
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring.h"
+
+/* Ring Function Definitions */
+
+/**
+ * It initializes the ring. If there is not
+ * enough memory to allocate the entries,
+ * then the application is exited.
+ *
+ * @param ring the ring
+ * @param capacity the amount of entries (a power of two)
+ * @param entry_size the size of an entry in bytes
+ */
+void ring_init(ring_t* ring, unsigned capacity, size_t entry_size) {
+    ring->entries = (char *)malloc(capacity * entry_size);
+
+    /* It checks if the ring entries could not be allocated */
+    if (!ring->entries) {
+        printf("Not enough memory to allocate a ring.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ring->entry_size = entry_size;
+    ring->mask = capacity - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->staged_tail = 0;
+}
+
+/**
+ * It stages the specified entry, such that it is
+ * seen by the consumer once it is published. It is
+ * supposed to be invoked by the producer only.
+ *
+ * @param ring the ring
+ * @param entry the entry to be copied into the ring
+ *
+ * @return 1 if the entry has been staged; otherwise,
+ *         if the ring is full, then 0 is returned.
+ */
+int ring_push(ring_t* ring, const void* entry) {
+    const unsigned head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    /* The indexes wrap around, hence their difference is the ring usage */
+    if (ring->staged_tail - head > ring->mask)
+        return 0;
+
+    memcpy(ring->entries + (ring->staged_tail & ring->mask) * ring->entry_size, entry, ring->entry_size);
+    ring->staged_tail++;
+    return 1;
+}
+
+/**
+ * It stages the specified entry, publishing the staged
+ * entries and yielding until the consumer makes room
+ * for it if the ring is full.
+ *
+ * @param ring the ring
+ * @param entry the entry to be copied into the ring
+ */
+void ring_push_wait(ring_t* ring, const void* entry) {
+    while (!ring_push(ring, entry)) {
+        ring_publish(ring);
+        sched_yield();
+    }
+}
+
+/**
+ * It publishes every staged entry. It is
+ * supposed to be invoked by the producer only.
+ *
+ * @param ring the ring
+ */
+void ring_publish(ring_t* ring) {
+    __atomic_store_n(&ring->tail, ring->staged_tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * It takes up to the specified amount of published
+ * entries. It is supposed to be invoked by the
+ * consumer only.
+ *
+ * @param ring the ring
+ * @param entries an array to receive the entries
+ * @param max the maximum amount of entries
+ *
+ * @return the amount of entries taken
+ */
+int ring_pop(ring_t* ring, void* entries, int max) {
+    const unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    unsigned head = ring->head;
+    int count = 0;
+
+    for (; head != tail && count < max; head++, count++)
+        memcpy((char *)entries + count * ring->entry_size,
+               ring->entries + (head & ring->mask) * ring->entry_size, ring->entry_size);
+
+    /* The entries are copied out before their slots are handed back */
+    if (count > 0)
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    return count;
+}
@@ -0,0 +1,103 @@
+#ifndef OS_PROJECT_RING_H
+#define OS_PROJECT_RING_H
+
+#include <stddef.h>
+
+/**
+ * It represents the size (bytes) of a cache line,
+ * such that the producer and the consumer indexes
+ * do not share one.
+ */
+#define RING_CACHE_LINE (64)
+
+/**
+ * A bounded single-producer/single-consumer queue of
+ * equally sized entries. The producer stages entries
+ * and publishes them at once, such that a batch costs
+ * a single release store, whereas the consumer takes
+ * every published entry at once. Neither side locks.
+ */
+typedef struct Ring {
+    /**
+     * It holds the entries, the size of
+     * an entry in bytes and the capacity
+     * (a power of two) minus one.
+     */
+    char* entries;
+    size_t entry_size;
+    unsigned mask;
+
+    /**
+     * It holds the index of the next entry
+     * to be consumed. It is only written by
+     * the consumer.
+     */
+    _Alignas(RING_CACHE_LINE) unsigned head;
+
+    /**
+     * It holds the index past the last published
+     * entry and the index past the last staged
+     * one. They are only written by the producer.
+     */
+    _Alignas(RING_CACHE_LINE) unsigned tail;
+    unsigned staged_tail;
+} ring_t;
+
+/* Ring Function Prototypes */
+
+/**
+ * It initializes the ring. If there is not
+ * enough memory to allocate the entries,
+ * then the application is exited.
+ *
+ * @param ring the ring
+ * @param capacity the amount of entries (a power of two)
+ * @param entry_size the size of an entry in bytes
+ */
+void ring_init(ring_t* ring, unsigned capacity, size_t entry_size);
+
+/**
+ * It stages the specified entry, such that it is
+ * seen by the consumer once it is published. It is
+ * supposed to be invoked by the producer only.
+ *
+ * @param ring the ring
+ * @param entry the entry to be copied into the ring
+ *
+ * @return 1 if the entry has been staged; otherwise,
+ *         if the ring is full, then 0 is returned.
+ */
+int ring_push(ring_t* ring, const void* entry);
+
+/**
+ * It stages the specified entry, publishing the staged
+ * entries and yielding until the consumer makes room
+ * for it if the ring is full.
+ *
+ * @param ring the ring
+ * @param entry the entry to be copied into the ring
+ */
+void ring_push_wait(ring_t* ring, const void* entry);
+
+/**
+ * It publishes every staged entry. It is
+ * supposed to be invoked by the producer only.
+ *
+ * @param ring the ring
+ */
+void ring_publish(ring_t* ring);
+
+/**
+ * It takes up to the specified amount of published
+ * entries. It is supposed to be invoked by the
+ * consumer only.
+ *
+ * @param ring the ring
+ * @param entries an array to receive the entries
+ * @param max the maximum amount of entries
+ *
+ * @return the amount of entries taken
+ */
+int ring_pop(ring_t* ring, void* entries, int max);
+
+#endif // OS_PROJECT_RING_H
@@ -0,0 +1,200 @@
+#include <stdlib.h>
+#include <stddef.h>
+
+#include "slab.h"
+
+/**
+ * It represents a per-thread stack of
+ * free objects of a slab cache.
+ */
+typedef struct SlabMagazine {
+    void* objs[SLAB_MAGAZINE_SIZE];
+    int count;
+} slab_magazine_t;
+
+/**
+ * The registered slab caches.
+ */
+static slab_cache_t* slab_caches[SLAB_MAX_CACHES];
+static int slab_cache_count = 0;
+static pthread_mutex_t slab_caches_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * The magazines of the current thread,
+ * indexed by the cache id.
+ */
+static __thread slab_magazine_t magazines[SLAB_MAX_CACHES];
+
+/* Slab Cache Internal Function Definitions */
+
+/**
+ * It registers the cache at its first use, such
+ * that it receives an index into the magazines.
+ *
+ * @param cache the slab cache
+ */
+static void slab_register(slab_cache_t* cache) {
+    pthread_mutex_lock(&slab_caches_mutex);
+
+    if (cache->id == -1) {
+        /* It checks if there is no room for another cache */
+        if (slab_cache_count == SLAB_MAX_CACHES) {
+            printf("Too many slab caches have been registered.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* Objects must be able to hold the depot link */
+        /* and be aligned as malloc'd memory would be */
+        if (cache->obj_size < sizeof(void *))
+            cache->obj_size = sizeof(void *);
+        cache->obj_size = (cache->obj_size + _Alignof(max_align_t) - 1)
+                          & ~(_Alignof(max_align_t) - 1);
+
+        slab_caches[slab_cache_count] = cache;
+        __atomic_store_n(&cache->id, slab_cache_count++, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&slab_caches_mutex);
+}
+
+/**
+ * It carves a new slab into objects and pushes
+ * them into the cache depot. It is supposed that
+ * the cache mutex is held.
+ *
+ * @param cache the slab cache
+ *
+ * @return 1 if the slab could be allocated;
+ *         otherwise, 0 is returned.
+ */
+static int slab_grow(slab_cache_t* cache) {
+    char* slab = (char *)malloc(cache->obj_size * SLAB_OBJECTS_PER_SLAB);
+    register int i;
+
+    /* It checks if the slab could not be allocated */
+    if (!slab)
+        return 0;
+
+    for (i = 0; i < SLAB_OBJECTS_PER_SLAB; i++) {
+        void** obj = (void **)(slab + i * cache->obj_size);
+
+        *obj = cache->depot;
+        cache->depot = obj;
+    }
+
+    cache->depot_size += SLAB_OBJECTS_PER_SLAB;
+    cache->slab_count++;
+    return 1;
+}
+
+/* Slab Cache Function Definitions */
+
+/**
+ * It returns a pointer to an object from the
+ * specified cache. If there is not enough memory
+ * to allocate a new slab, then NULL is returned.
+ *
+ * @param cache the slab cache
+ *
+ * @return a pointer to an object or NULL if
+ *         there is not enough memory.
+ */
+void* slab_alloc(slab_cache_t* cache) {
+    slab_magazine_t* mag;
+
+    if (__atomic_load_n(&cache->id, __ATOMIC_ACQUIRE) == -1)
+        slab_register(cache);
+
+    mag = &magazines[cache->id];
+
+    /* It refills half of the magazine from the */
+    /* depot whenever the magazine is empty */
+    if (mag->count == 0) {
+        pthread_mutex_lock(&cache->mutex);
+
+        while (mag->count < SLAB_MAGAZINE_SIZE / 2) {
+            if (!cache->depot && !slab_grow(cache))
+                break;
+
+            mag->objs[mag->count++] = cache->depot;
+            cache->depot = *(void **)cache->depot;
+            cache->depot_size--;
+        }
+
+        cache->refill_count++;
+        pthread_mutex_unlock(&cache->mutex);
+
+        /* It checks if no object could be allocated */
+        if (mag->count == 0)
+            return NULL;
+    }
+
+    __atomic_fetch_add(&cache->alloc_count, 1, __ATOMIC_RELAXED);
+    return mag->objs[--mag->count];
+}
+
+/**
+ * It returns the object to the specified cache.
+ * Nothing is done if the object is NULL.
+ *
+ * @param cache the slab cache
+ * @param obj the object to be freed
+ */
+void slab_free(slab_cache_t* cache, void* obj) {
+    slab_magazine_t* mag;
+
+    if (!obj)
+        return;
+
+    if (__atomic_load_n(&cache->id, __ATOMIC_ACQUIRE) == -1)
+        slab_register(cache);
+
+    mag = &magazines[cache->id];
+
+    /* It flushes half of the magazine into the */
+    /* depot whenever the magazine is full */
+    if (mag->count == SLAB_MAGAZINE_SIZE) {
+        pthread_mutex_lock(&cache->mutex);
+
+        while (mag->count > SLAB_MAGAZINE_SIZE / 2) {
+            void** flushed = (void **)mag->objs[--mag->count];
+
+            *flushed = cache->depot;
+            cache->depot = flushed;
+            cache->depot_size++;
+        }
+
+        cache->flush_count++;
+        pthread_mutex_unlock(&cache->mutex);
+    }
+
+    __atomic_fetch_add(&cache->free_count, 1, __ATOMIC_RELAXED);
+    mag->objs[mag->count++] = obj;
+}
+
+/**
+ * It prints the allocation counters
+ * of every registered cache.
+ *
+ * @param fp the file to be printed to
+ */
+void slab_report(FILE* fp) {
+    register int i;
+
+    pthread_mutex_lock(&slab_caches_mutex);
+
+    fprintf(fp, "%-16s %8s %10s %10s %10s %8s %8s %8s\n", "Cache", "ObjSize",
+            "Allocs", "Frees", "InUse", "Slabs", "Refills", "Flushes");
+
+    for (i = 0; i < slab_cache_count; i++) {
+        const slab_cache_t* cache = slab_caches[i];
+        const long allocs = __atomic_load_n(&cache->alloc_count, __ATOMIC_RELAXED);
+        const long frees = __atomic_load_n(&cache->free_count, __ATOMIC_RELAXED);
+
+        fprintf(fp, "%-16s %8zu %10ld %10ld %10ld %8ld %8ld %8ld\n", cache->name,
+                cache->obj_size, allocs, frees, allocs - frees, cache->slab_count,
+                cache->refill_count, cache->flush_count);
+    }
+
+    pthread_mutex_unlock(&slab_caches_mutex);
+}
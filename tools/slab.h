@@ -0,0 +1,128 @@
+#ifndef OS_PROJECT_SLAB_H
+#define OS_PROJECT_SLAB_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+/**
+ * It represents the amount of free objects
+ * each thread may hold for each cache without
+ * touching the cache shared depot.
+ */
+#define SLAB_MAGAZINE_SIZE (32)
+
+/**
+ * It represents the amount of objects that
+ * are carved out from each slab.
+ */
+#define SLAB_OBJECTS_PER_SLAB (64)
+
+/**
+ * It represents the maximum amount of
+ * slab caches that may be registered.
+ */
+#define SLAB_MAX_CACHES (32)
+
+/**
+ * It statically initializes a slab cache for
+ * objects of the specified type.
+ */
+#define SLAB_CACHE_INITIALIZER(NAME, TYPE)                                     \
+    { .name = (NAME), .obj_size = sizeof(TYPE), .id = -1,                      \
+      .mutex = PTHREAD_MUTEX_INITIALIZER }
+
+/**
+ * A cache of equally sized objects. Free objects
+ * are kept in per-thread magazines, such that the
+ * hot allocation paths do not need any lock, and
+ * in a shared depot that refills the magazines.
+ */
+typedef struct SlabCache {
+    /**
+     * It holds the cache name.
+     */
+    const char* name;
+
+    /**
+     * It holds the size of the
+     * cached objects in bytes.
+     */
+    size_t obj_size;
+
+    /**
+     * It holds the cache index into the
+     * thread-local magazines. It is -1 while
+     * the cache has not been used yet.
+     */
+    int id;
+
+    /**
+     * It ensures mutual exclusion when
+     * handling the cache depot.
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     * It holds the free objects that are not
+     * in any magazine, linked through their
+     * first word.
+     */
+    void* depot;
+    int depot_size;
+
+    /* Statistics Information */
+
+    /**
+     * It holds the amount of allocated
+     * and freed objects.
+     */
+    long alloc_count;
+    long free_count;
+
+    /**
+     * It holds the amount of slabs that
+     * have been carved into objects.
+     */
+    long slab_count;
+
+    /**
+     * It holds the amount of times the
+     * magazines have been refilled from
+     * and flushed to the depot.
+     */
+    long refill_count;
+    long flush_count;
+} slab_cache_t;
+
+/* Slab Cache Function Prototypes */
+
+/**
+ * It returns a pointer to an object from the
+ * specified cache. If there is not enough memory
+ * to allocate a new slab, then NULL is returned.
+ *
+ * @param cache the slab cache
+ *
+ * @return a pointer to an object or NULL if
+ *         there is not enough memory.
+ */
+void* slab_alloc(slab_cache_t* cache);
+
+/**
+ * It returns the object to the specified cache.
+ * Nothing is done if the object is NULL.
+ *
+ * @param cache the slab cache
+ * @param obj the object to be freed
+ */
+void slab_free(slab_cache_t* cache, void* obj);
+
+/**
+ * It prints the allocation counters
+ * of every registered cache.
+ *
+ * @param fp the file to be printed to
+ */
+void slab_report(FILE* fp);
+
+#endif // OS_PROJECT_SLAB_H